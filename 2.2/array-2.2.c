@@ -0,0 +1,880 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+#include "array-2.2.h"
+#include "number-2.2.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ARRAY_SIMD 1
+#else
+#define ARRAY_SIMD 0
+#endif
+
+// Elementi elaborati per blocco da MAP: abbastanza per ammortizzare la lettura del codice RPN,
+// abbastanza pochi perché le colonne intermedie restino in cache
+#define ARRAY_CHUNK 256
+
+// -------------------------- KERNEL --------------------------
+// Ogni operazione di massa ha una versione scalare, SSE2 e AVX2 con la stessa semantica.
+// Somme e prodotti scalari accumulano sempre su 4 corsie (l'elemento i nella corsia i % 4)
+// combinate come (c0 + c1) + (c2 + c3): il risultato non dipende dalla CPU che esegue lo script.
+
+typedef struct {
+    const char *name;
+    void (*fill_f64)(double *dst, double value, size_t n);
+    void (*fill_i64)(int64_t *dst, int64_t value, size_t n);
+    void (*add_f64)(double *dst, const double *a, const double *b, size_t n);
+    void (*sub_f64)(double *dst, const double *a, const double *b, size_t n);
+    void (*mul_f64)(double *dst, const double *a, const double *b, size_t n);
+    void (*div_f64)(double *dst, const double *a, const double *b, size_t n);
+    bool (*add_i64)(int64_t *dst, const int64_t *a, const int64_t *b, size_t n); // false in caso di overflow
+    bool (*sub_i64)(int64_t *dst, const int64_t *a, const int64_t *b, size_t n);
+    double (*sum_f64)(const double *a, size_t n);
+    bool (*sum_i64)(const int64_t *a, size_t n, int64_t *out);
+    double (*dot_f64)(const double *a, const double *b, size_t n);
+    double (*min_f64)(const double *a, size_t n);
+    double (*max_f64)(const double *a, size_t n);
+    int64_t (*min_i64)(const int64_t *a, size_t n);
+    int64_t (*max_i64)(const int64_t *a, size_t n);
+} ArrayKernels;
+
+// Combina le 4 corsie e aggiunge gli elementi rimasti fuori dai blocchi
+static double finish_sum_f64(const double lane[4], double tail) {
+    return ((lane[0] + lane[1]) + (lane[2] + lane[3])) + tail;
+}
+
+static bool finish_sum_i64(const int64_t lane[4], const int64_t *tail, size_t n, bool overflow, int64_t *out) {
+    int64_t low, high, sum;
+    overflow |= __builtin_add_overflow(lane[0], lane[1], &low);
+    overflow |= __builtin_add_overflow(lane[2], lane[3], &high);
+    overflow |= __builtin_add_overflow(low, high, &sum);
+    for (size_t i = 0; i < n; i++) overflow |= __builtin_add_overflow(sum, tail[i], &sum);
+    *out = sum;
+    return !overflow;
+}
+
+// ---------- Scalare ----------
+
+static void fill_f64_scalar(double *dst, double value, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = value;
+}
+
+static void fill_i64_scalar(int64_t *dst, int64_t value, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = value;
+}
+
+#define SCALAR_BINARY_F64(name, op)                                                        \
+    static void name##_f64_scalar(double *dst, const double *a, const double *b, size_t n) { \
+        for (size_t i = 0; i < n; i++) dst[i] = a[i] op b[i];                              \
+    }
+
+SCALAR_BINARY_F64(add, +)
+SCALAR_BINARY_F64(sub, -)
+SCALAR_BINARY_F64(mul, *)
+SCALAR_BINARY_F64(div, /)
+
+static bool add_i64_scalar(int64_t *dst, const int64_t *a, const int64_t *b, size_t n) {
+    bool overflow = false;
+    for (size_t i = 0; i < n; i++) overflow |= __builtin_add_overflow(a[i], b[i], &dst[i]);
+    return !overflow;
+}
+
+static bool sub_i64_scalar(int64_t *dst, const int64_t *a, const int64_t *b, size_t n) {
+    bool overflow = false;
+    for (size_t i = 0; i < n; i++) overflow |= __builtin_sub_overflow(a[i], b[i], &dst[i]);
+    return !overflow;
+}
+
+static double sum_f64_scalar(const double *a, size_t n) {
+    double lane[4] = {0, 0, 0, 0}, tail = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        for (int k = 0; k < 4; k++) lane[k] += a[i + k];
+    for (; i < n; i++) tail += a[i];
+    return finish_sum_f64(lane, tail);
+}
+
+static bool sum_i64_scalar(const int64_t *a, size_t n, int64_t *out) {
+    int64_t lane[4] = {0, 0, 0, 0};
+    bool overflow = false;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        for (int k = 0; k < 4; k++) overflow |= __builtin_add_overflow(lane[k], a[i + k], &lane[k]);
+    return finish_sum_i64(lane, a + i, n - i, overflow, out);
+}
+
+static double dot_f64_scalar(const double *a, const double *b, size_t n) {
+    double lane[4] = {0, 0, 0, 0}, tail = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        for (int k = 0; k < 4; k++) lane[k] += a[i + k] * b[i + k];
+    for (; i < n; i++) tail += a[i] * b[i];
+    return finish_sum_f64(lane, tail);
+}
+
+// Stessa scelta di MINPD/MAXPD: a parità (o con NaN) vince il secondo operando
+static double min_f64_scalar(const double *a, size_t n) {
+    double m = a[0];
+    for (size_t i = 1; i < n; i++) m = m < a[i] ? m : a[i];
+    return m;
+}
+
+static double max_f64_scalar(const double *a, size_t n) {
+    double m = a[0];
+    for (size_t i = 1; i < n; i++) m = m > a[i] ? m : a[i];
+    return m;
+}
+
+static int64_t min_i64_scalar(const int64_t *a, size_t n) {
+    int64_t m = a[0];
+    for (size_t i = 1; i < n; i++) if (a[i] < m) m = a[i];
+    return m;
+}
+
+static int64_t max_i64_scalar(const int64_t *a, size_t n) {
+    int64_t m = a[0];
+    for (size_t i = 1; i < n; i++) if (a[i] > m) m = a[i];
+    return m;
+}
+
+static const ArrayKernels scalar_kernels = {
+    "scalar", fill_f64_scalar, fill_i64_scalar,
+    add_f64_scalar, sub_f64_scalar, mul_f64_scalar, div_f64_scalar, add_i64_scalar, sub_i64_scalar,
+    sum_f64_scalar, sum_i64_scalar, dot_f64_scalar,
+    min_f64_scalar, max_f64_scalar, min_i64_scalar, max_i64_scalar,
+};
+
+#if ARRAY_SIMD
+
+// Overflow di una somma/differenza a 64 bit: bit di segno di (x ^ r) & (y ^ r) oppure (x ^ y) & (x ^ r)
+#define SSE2_ADD_OVERFLOW(x, y, r) _mm_and_si128(_mm_xor_si128(x, r), _mm_xor_si128(y, r))
+#define SSE2_SUB_OVERFLOW(x, y, r) _mm_and_si128(_mm_xor_si128(x, y), _mm_xor_si128(x, r))
+
+// ---------- SSE2 (2 elementi per registro) ----------
+
+__attribute__((target("sse2")))
+static void fill_f64_sse2(double *dst, double value, size_t n) {
+    __m128d v = _mm_set1_pd(value);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(dst + i, v);
+    for (; i < n; i++) dst[i] = value;
+}
+
+__attribute__((target("sse2")))
+static void fill_i64_sse2(int64_t *dst, int64_t value, size_t n) {
+    __m128i v = _mm_set1_epi64x(value);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_si128((__m128i *)(dst + i), v);
+    for (; i < n; i++) dst[i] = value;
+}
+
+#define SSE2_BINARY_F64(name, intrinsic, op)                                                   \
+    __attribute__((target("sse2")))                                                            \
+    static void name##_f64_sse2(double *dst, const double *a, const double *b, size_t n) {     \
+        size_t i = 0;                                                                          \
+        for (; i + 2 <= n; i += 2)                                                             \
+            _mm_storeu_pd(dst + i, intrinsic(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));       \
+        for (; i < n; i++) dst[i] = a[i] op b[i];                                              \
+    }
+
+SSE2_BINARY_F64(add, _mm_add_pd, +)
+SSE2_BINARY_F64(sub, _mm_sub_pd, -)
+SSE2_BINARY_F64(mul, _mm_mul_pd, *)
+SSE2_BINARY_F64(div, _mm_div_pd, /)
+
+__attribute__((target("sse2")))
+static bool add_i64_sse2(int64_t *dst, const int64_t *a, const int64_t *b, size_t n) {
+    __m128i overflow = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+        __m128i r = _mm_add_epi64(x, y);
+        overflow = _mm_or_si128(overflow, SSE2_ADD_OVERFLOW(x, y, r));
+        _mm_storeu_si128((__m128i *)(dst + i), r);
+    }
+    bool ok = _mm_movemask_pd(_mm_castsi128_pd(overflow)) == 0;
+    return add_i64_scalar(dst + i, a + i, b + i, n - i) && ok;
+}
+
+__attribute__((target("sse2")))
+static bool sub_i64_sse2(int64_t *dst, const int64_t *a, const int64_t *b, size_t n) {
+    __m128i overflow = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+        __m128i r = _mm_sub_epi64(x, y);
+        overflow = _mm_or_si128(overflow, SSE2_SUB_OVERFLOW(x, y, r));
+        _mm_storeu_si128((__m128i *)(dst + i), r);
+    }
+    bool ok = _mm_movemask_pd(_mm_castsi128_pd(overflow)) == 0;
+    return sub_i64_scalar(dst + i, a + i, b + i, n - i) && ok;
+}
+
+// Due registri = le 4 corsie della versione scalare
+__attribute__((target("sse2")))
+static double sum_f64_sse2(const double *a, size_t n) {
+    __m128d low = _mm_setzero_pd(), high = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        low = _mm_add_pd(low, _mm_loadu_pd(a + i));
+        high = _mm_add_pd(high, _mm_loadu_pd(a + i + 2));
+    }
+    double lane[4], tail = 0;
+    _mm_storeu_pd(lane, low);
+    _mm_storeu_pd(lane + 2, high);
+    for (; i < n; i++) tail += a[i];
+    return finish_sum_f64(lane, tail);
+}
+
+__attribute__((target("sse2")))
+static bool sum_i64_sse2(const int64_t *a, size_t n, int64_t *out) {
+    __m128i low = _mm_setzero_si128(), high = _mm_setzero_si128(), overflow = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i *)(a + i + 2));
+        __m128i r = _mm_add_epi64(low, x);
+        __m128i s = _mm_add_epi64(high, y);
+        overflow = _mm_or_si128(overflow, _mm_or_si128(SSE2_ADD_OVERFLOW(low, x, r), SSE2_ADD_OVERFLOW(high, y, s)));
+        low = r;
+        high = s;
+    }
+    int64_t lane[4];
+    _mm_storeu_si128((__m128i *)lane, low);
+    _mm_storeu_si128((__m128i *)(lane + 2), high);
+    return finish_sum_i64(lane, a + i, n - i, _mm_movemask_pd(_mm_castsi128_pd(overflow)) != 0, out);
+}
+
+__attribute__((target("sse2")))
+static double dot_f64_sse2(const double *a, const double *b, size_t n) {
+    __m128d low = _mm_setzero_pd(), high = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        low = _mm_add_pd(low, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        high = _mm_add_pd(high, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+    }
+    double lane[4], tail = 0;
+    _mm_storeu_pd(lane, low);
+    _mm_storeu_pd(lane + 2, high);
+    for (; i < n; i++) tail += a[i] * b[i];
+    return finish_sum_f64(lane, tail);
+}
+
+#define SSE2_EXTREME_F64(name, intrinsic)                                       \
+    __attribute__((target("sse2")))                                             \
+    static double name##_f64_sse2(const double *a, size_t n) {                  \
+        if (n < 2) return name##_f64_scalar(a, n);                              \
+        __m128d m = _mm_loadu_pd(a);                                            \
+        size_t i = 2;                                                           \
+        for (; i + 2 <= n; i += 2) m = intrinsic(m, _mm_loadu_pd(a + i));       \
+        double lane[2];                                                         \
+        _mm_storeu_pd(lane, m);                                                 \
+        double rest[3] = {lane[0], lane[1], 0};                                 \
+        if (i < n) rest[2] = a[i];                                              \
+        return name##_f64_scalar(rest, i < n ? 3 : 2);                          \
+    }
+
+SSE2_EXTREME_F64(min, _mm_min_pd)
+SSE2_EXTREME_F64(max, _mm_max_pd)
+
+// SSE2 non ha confronti a 64 bit: MIN/MAX interi restano scalari
+static const ArrayKernels sse2_kernels = {
+    "sse2", fill_f64_sse2, fill_i64_sse2,
+    add_f64_sse2, sub_f64_sse2, mul_f64_sse2, div_f64_sse2, add_i64_sse2, sub_i64_sse2,
+    sum_f64_sse2, sum_i64_sse2, dot_f64_sse2,
+    min_f64_sse2, max_f64_sse2, min_i64_scalar, max_i64_scalar,
+};
+
+// ---------- AVX2 (4 elementi per registro) ----------
+
+#define AVX2_ADD_OVERFLOW(x, y, r) _mm256_and_si256(_mm256_xor_si256(x, r), _mm256_xor_si256(y, r))
+#define AVX2_SUB_OVERFLOW(x, y, r) _mm256_and_si256(_mm256_xor_si256(x, y), _mm256_xor_si256(x, r))
+
+__attribute__((target("avx2")))
+static void fill_f64_avx2(double *dst, double value, size_t n) {
+    __m256d v = _mm256_set1_pd(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_pd(dst + i, v);
+    for (; i < n; i++) dst[i] = value;
+}
+
+__attribute__((target("avx2")))
+static void fill_i64_avx2(int64_t *dst, int64_t value, size_t n) {
+    __m256i v = _mm256_set1_epi64x(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_si256((__m256i *)(dst + i), v);
+    for (; i < n; i++) dst[i] = value;
+}
+
+#define AVX2_BINARY_F64(name, intrinsic, op)                                                   \
+    __attribute__((target("avx2")))                                                            \
+    static void name##_f64_avx2(double *dst, const double *a, const double *b, size_t n) {     \
+        size_t i = 0;                                                                          \
+        for (; i + 4 <= n; i += 4)                                                             \
+            _mm256_storeu_pd(dst + i, intrinsic(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i))); \
+        for (; i < n; i++) dst[i] = a[i] op b[i];                                              \
+    }
+
+AVX2_BINARY_F64(add, _mm256_add_pd, +)
+AVX2_BINARY_F64(sub, _mm256_sub_pd, -)
+AVX2_BINARY_F64(mul, _mm256_mul_pd, *)
+AVX2_BINARY_F64(div, _mm256_div_pd, /)
+
+__attribute__((target("avx2")))
+static bool add_i64_avx2(int64_t *dst, const int64_t *a, const int64_t *b, size_t n) {
+    __m256i overflow = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+        __m256i r = _mm256_add_epi64(x, y);
+        overflow = _mm256_or_si256(overflow, AVX2_ADD_OVERFLOW(x, y, r));
+        _mm256_storeu_si256((__m256i *)(dst + i), r);
+    }
+    bool ok = _mm256_movemask_pd(_mm256_castsi256_pd(overflow)) == 0;
+    return add_i64_scalar(dst + i, a + i, b + i, n - i) && ok;
+}
+
+__attribute__((target("avx2")))
+static bool sub_i64_avx2(int64_t *dst, const int64_t *a, const int64_t *b, size_t n) {
+    __m256i overflow = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+        __m256i r = _mm256_sub_epi64(x, y);
+        overflow = _mm256_or_si256(overflow, AVX2_SUB_OVERFLOW(x, y, r));
+        _mm256_storeu_si256((__m256i *)(dst + i), r);
+    }
+    bool ok = _mm256_movemask_pd(_mm256_castsi256_pd(overflow)) == 0;
+    return sub_i64_scalar(dst + i, a + i, b + i, n - i) && ok;
+}
+
+__attribute__((target("avx2")))
+static double sum_f64_avx2(const double *a, size_t n) {
+    __m256d sum = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) sum = _mm256_add_pd(sum, _mm256_loadu_pd(a + i));
+    double lane[4], tail = 0;
+    _mm256_storeu_pd(lane, sum);
+    for (; i < n; i++) tail += a[i];
+    return finish_sum_f64(lane, tail);
+}
+
+__attribute__((target("avx2")))
+static bool sum_i64_avx2(const int64_t *a, size_t n, int64_t *out) {
+    __m256i sum = _mm256_setzero_si256(), overflow = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i r = _mm256_add_epi64(sum, x);
+        overflow = _mm256_or_si256(overflow, AVX2_ADD_OVERFLOW(sum, x, r));
+        sum = r;
+    }
+    int64_t lane[4];
+    _mm256_storeu_si256((__m256i *)lane, sum);
+    return finish_sum_i64(lane, a + i, n - i, _mm256_movemask_pd(_mm256_castsi256_pd(overflow)) != 0, out);
+}
+
+// Niente FMA: moltiplicazione e somma separate danno gli stessi arrotondamenti delle altre versioni
+__attribute__((target("avx2")))
+static double dot_f64_avx2(const double *a, const double *b, size_t n) {
+    __m256d sum = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    double lane[4], tail = 0;
+    _mm256_storeu_pd(lane, sum);
+    for (; i < n; i++) tail += a[i] * b[i];
+    return finish_sum_f64(lane, tail);
+}
+
+#define AVX2_EXTREME_F64(name, intrinsic)                                       \
+    __attribute__((target("avx2")))                                             \
+    static double name##_f64_avx2(const double *a, size_t n) {                  \
+        if (n < 4) return name##_f64_scalar(a, n);                              \
+        __m256d m = _mm256_loadu_pd(a);                                         \
+        size_t i = 4;                                                           \
+        for (; i + 4 <= n; i += 4) m = intrinsic(m, _mm256_loadu_pd(a + i));    \
+        double rest[7];                                                         \
+        _mm256_storeu_pd(rest, m);                                              \
+        size_t count = 4;                                                       \
+        for (; i < n; i++) rest[count++] = a[i];                                \
+        return name##_f64_scalar(rest, count);                                  \
+    }
+
+AVX2_EXTREME_F64(min, _mm256_min_pd)
+AVX2_EXTREME_F64(max, _mm256_max_pd)
+
+__attribute__((target("avx2")))
+static int64_t min_i64_avx2(const int64_t *a, size_t n) {
+    if (n < 4) return min_i64_scalar(a, n);
+    __m256i m = _mm256_loadu_si256((const __m256i *)a);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        m = _mm256_blendv_epi8(m, x, _mm256_cmpgt_epi64(m, x));
+    }
+    int64_t rest[7];
+    _mm256_storeu_si256((__m256i *)rest, m);
+    size_t count = 4;
+    for (; i < n; i++) rest[count++] = a[i];
+    return min_i64_scalar(rest, count);
+}
+
+__attribute__((target("avx2")))
+static int64_t max_i64_avx2(const int64_t *a, size_t n) {
+    if (n < 4) return max_i64_scalar(a, n);
+    __m256i m = _mm256_loadu_si256((const __m256i *)a);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        m = _mm256_blendv_epi8(m, x, _mm256_cmpgt_epi64(x, m));
+    }
+    int64_t rest[7];
+    _mm256_storeu_si256((__m256i *)rest, m);
+    size_t count = 4;
+    for (; i < n; i++) rest[count++] = a[i];
+    return max_i64_scalar(rest, count);
+}
+
+static const ArrayKernels avx2_kernels = {
+    "avx2", fill_f64_avx2, fill_i64_avx2,
+    add_f64_avx2, sub_f64_avx2, mul_f64_avx2, div_f64_avx2, add_i64_avx2, sub_i64_avx2,
+    sum_f64_avx2, sum_i64_avx2, dot_f64_avx2,
+    min_f64_avx2, max_f64_avx2, min_i64_avx2, max_i64_avx2,
+};
+
+#endif
+
+// ---------- Scelta a runtime ----------
+
+static const ArrayKernels *active_kernels = &scalar_kernels;
+static pthread_once_t kernels_once = PTHREAD_ONCE_INIT;
+
+// La migliore versione supportata dalla CPU; NOOBIE_SIMD=scalar|sse2|avx2 la limita (confronti, benchmark)
+static void select_kernels(void) {
+#if ARRAY_SIMD
+    const char *forced = getenv("NOOBIE_SIMD");
+    if (forced && strcmp(forced, "scalar") == 0) return;
+
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && !(forced && strcmp(forced, "sse2") == 0))
+        active_kernels = &avx2_kernels;
+    else if (__builtin_cpu_supports("sse2"))
+        active_kernels = &sse2_kernels;
+#endif
+}
+
+static const ArrayKernels *get_kernels(void) {
+    pthread_once(&kernels_once, select_kernels);
+    return active_kernels;
+}
+
+// Nome dei kernel in uso (trace)
+const char *get_array_kernels_name(void) {
+    return get_kernels()->name;
+}
+
+// -------------------------- ARRAY --------------------------
+
+bool is_array_type(VarType type) {
+    return type == TYPE_ARRAY_INT || type == TYPE_ARRAY_FLOAT;
+}
+
+// Nuovo array di len elementi a zero (NULL se la memoria non basta)
+Array *new_array(VarType type, size_t len) {
+    Array *array = malloc(sizeof(Array));
+    if (!array) return NULL;
+
+    size_t bytes = (len * sizeof(int64_t) + ARRAY_ALIGN - 1) & ~(size_t)(ARRAY_ALIGN - 1);
+    array->data.raw = aligned_alloc(ARRAY_ALIGN, bytes ? bytes : ARRAY_ALIGN);
+    if (!array->data.raw) {
+        free(array);
+        return NULL;
+    }
+    memset(array->data.raw, 0, bytes);
+    array->type = type;
+    array->len = len;
+    return array;
+}
+
+void free_array(Array *array) {
+    if (!array) return;
+    free(array->data.raw);
+    free(array);
+}
+
+// Assegna lo stesso valore a tutti gli elementi (un INT va bene anche per un array FLOAT)
+void fill_array(Interpreter *interp, Array *array, CalcResult value, int line_number) {
+    const ArrayKernels *kernels = get_kernels();
+    if (array->type == TYPE_INT && value.type == TYPE_INT)
+        kernels->fill_i64(array->data.i, value.value.i_val, array->len);
+    else if (array->type == TYPE_FLOAT && value.type == TYPE_INT)
+        kernels->fill_f64(array->data.f, (double)value.value.i_val, array->len);
+    else if (array->type == TYPE_FLOAT && value.type == TYPE_FLOAT)
+        kernels->fill_f64(array->data.f, value.value.f_val, array->len);
+    else
+        handle_error(interp, "VALUE DOES NOT MATCH ARRAY TYPE. ", line_number);
+}
+
+// Accoda un elemento (index >= 0) oppure l'intero array come "[a, b, c]"
+void append_array(TextBuffer *out, const Array *array, int64_t index) {
+    size_t first = 0, last = array->len;
+
+    if (index >= 0) {
+        if ((uint64_t)index >= array->len) {
+            text_append(out, "[undefined]", 11);
+            return;
+        }
+        first = (size_t)index;
+        last = first + 1;
+    } else
+        text_append(out, "[", 1);
+
+    for (size_t i = first; i < last; i++) {
+        if (i > first) text_append(out, ", ", 2);
+        if (array->type == TYPE_INT) text_append_int(out, array->data.i[i]);
+        else text_append_fixed(out, array->data.f[i], 2);
+    }
+    if (index < 0) text_append(out, "]", 1);
+}
+
+// -------------------------- RIDUZIONI --------------------------
+
+static CalcResult int_result(int64_t value) {
+    CalcResult result = {TYPE_INT, {.i_val = value}};
+    return result;
+}
+
+static CalcResult float_result(double value) {
+    CalcResult result = {TYPE_FLOAT, {.f_val = value}};
+    return result;
+}
+
+// Converte un blocco di INT in double
+static void int_to_double(double *dst, const int64_t *src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = (double)src[i];
+}
+
+// Somma di un array INT in double, a blocchi (media quando la somma esatta non sta in 64 bit)
+static double sum_ints_as_double(const ArrayKernels *kernels, const int64_t *a, size_t n) {
+    _Alignas(ARRAY_ALIGN) double block[ARRAY_CHUNK];
+    double sum = 0;
+    for (size_t base = 0; base < n; base += ARRAY_CHUNK) {
+        size_t len = n - base < ARRAY_CHUNK ? n - base : ARRAY_CHUNK;
+        int_to_double(block, a + base, len);
+        sum += kernels->sum_f64(block, len);
+    }
+    return sum;
+}
+
+// SUM e MIN/MAX restituiscono il tipo degli elementi, MEAN sempre FLOAT
+CalcResult reduce_array(Interpreter *interp, const Array *array, ReduceKind kind, int line_number) {
+    const ArrayKernels *kernels = get_kernels();
+    if (array->len == 0) handle_error(interp, "EMPTY ARRAY. ", line_number);
+
+    if (array->type == TYPE_FLOAT) {
+        switch (kind) {
+            case REDUCE_SUM: return float_result(kernels->sum_f64(array->data.f, array->len));
+            case REDUCE_MIN: return float_result(kernels->min_f64(array->data.f, array->len));
+            case REDUCE_MAX: return float_result(kernels->max_f64(array->data.f, array->len));
+            case REDUCE_MEAN: return float_result(kernels->sum_f64(array->data.f, array->len) / (double)array->len);
+        }
+    }
+
+    int64_t sum;
+    switch (kind) {
+        case REDUCE_SUM:
+            if (!kernels->sum_i64(array->data.i, array->len, &sum)) handle_error(interp, "INTEGER OVERFLOW. ", line_number);
+            return int_result(sum);
+        case REDUCE_MIN: return int_result(kernels->min_i64(array->data.i, array->len));
+        case REDUCE_MAX: return int_result(kernels->max_i64(array->data.i, array->len));
+        case REDUCE_MEAN:
+            if (kernels->sum_i64(array->data.i, array->len, &sum)) return float_result((double)sum / (double)array->len);
+            return float_result(sum_ints_as_double(kernels, array->data.i, array->len) / (double)array->len);
+    }
+    return int_result(0);
+}
+
+// Prodotto scalare: INT se entrambi gli array sono INT (con controllo dell'overflow), altrimenti FLOAT
+CalcResult dot_arrays(Interpreter *interp, const Array *a, const Array *b, int line_number) {
+    const ArrayKernels *kernels = get_kernels();
+    if (a->len != b->len) handle_error(interp, "ARRAY SIZE MISMATCH. ", line_number);
+
+    if (a->type == TYPE_INT && b->type == TYPE_INT) {
+        int64_t sum = 0, product;
+        bool overflow = false;
+        for (size_t i = 0; i < a->len; i++) {
+            overflow |= __builtin_mul_overflow(a->data.i[i], b->data.i[i], &product);
+            overflow |= __builtin_add_overflow(sum, product, &sum);
+        }
+        if (overflow) handle_error(interp, "INTEGER OVERFLOW. ", line_number);
+        return int_result(sum);
+    }
+    if (a->type == TYPE_FLOAT && b->type == TYPE_FLOAT) return float_result(kernels->dot_f64(a->data.f, b->data.f, a->len));
+
+    // Misto: la parte INT viene convertita a blocchi
+    const Array *floats = a->type == TYPE_FLOAT ? a : b;
+    const Array *ints = a->type == TYPE_FLOAT ? b : a;
+    _Alignas(ARRAY_ALIGN) double block[ARRAY_CHUNK];
+    double sum = 0;
+    for (size_t base = 0; base < a->len; base += ARRAY_CHUNK) {
+        size_t len = a->len - base < ARRAY_CHUNK ? a->len - base : ARRAY_CHUNK;
+        int_to_double(block, ints->data.i + base, len);
+        sum += kernels->dot_f64(floats->data.f + base, block, len);
+    }
+    return float_result(sum);
+}
+
+// -------------------------- MAP --------------------------
+// L'espressione viene valutata a blocchi di ARRAY_CHUNK elementi: ogni posizione della pila RPN
+// è una colonna (uno scalare ripetuto oppure un blocco di valori). Le operazioni aritmetiche
+// tra colonne usano i kernel; le altre passano elemento per elemento dagli operatori di CALC.
+
+typedef struct {
+    VarType type;       // TYPE_INT, TYPE_FLOAT o TYPE_BOOL (0/1 negli interi)
+    bool is_scalar;
+    CalcResult scalar;
+    const void *data;   // blocco corrente: il proprio buffer o direttamente un array
+    void *buffer;       // ARRAY_CHUNK elementi allineati
+} Column;
+
+// Buffer di lavoro allineato nel contesto: sopravvive agli errori (longjmp) senza perdite
+static void *scratch_buffer(Interpreter *interp, size_t size) {
+    if (size > interp->scratch_size) {
+        free(interp->scratch);
+        interp->scratch = aligned_alloc(ARRAY_ALIGN, size);
+        interp->scratch_size = interp->scratch ? size : 0;
+        if (!interp->scratch) handle_error(NULL, "OUT OF MEMORY. ", -1);
+    }
+    return interp->scratch;
+}
+
+static CalcResult column_get(const Column *column, size_t i) {
+    if (column->is_scalar) return column->scalar;
+    CalcResult value = {column->type, {0}};
+    if (column->type == TYPE_FLOAT) value.value.f_val = ((const double *)column->data)[i];
+    else if (column->type == TYPE_INT) value.value.i_val = ((const int64_t *)column->data)[i];
+    else value.value.b_val = ((const int64_t *)column->data)[i] != 0;
+    return value;
+}
+
+// Scrive un risultato nel buffer della colonna (il tipo della colonna cambia solo a blocco finito)
+static void column_store(Column *column, size_t i, CalcResult value) {
+    if (value.type == TYPE_FLOAT) ((double *)column->buffer)[i] = value.value.f_val;
+    else if (value.type == TYPE_INT) ((int64_t *)column->buffer)[i] = value.value.i_val;
+    else ((int64_t *)column->buffer)[i] = value.value.b_val;
+}
+
+// Converte in double i primi n interi già scritti nel buffer della colonna
+static void promote_column(Column *column, size_t n) {
+    char *buffer = column->buffer;
+    for (size_t i = 0; i < n; i++) {
+        int64_t value;
+        memcpy(&value, buffer + i * sizeof(int64_t), sizeof(value));
+        double converted = (double)value;
+        memcpy(buffer + i * sizeof(double), &converted, sizeof(converted));
+    }
+}
+
+// La colonna come blocco di double (convertita o ripetuta in tmp se necessario)
+static const double *column_f64(const ArrayKernels *kernels, const Column *column, double *tmp, size_t n) {
+    if (column->is_scalar) {
+        double value = column->scalar.type == TYPE_FLOAT ? column->scalar.value.f_val : (double)column->scalar.value.i_val;
+        kernels->fill_f64(tmp, value, n);
+        return tmp;
+    }
+    if (column->type == TYPE_FLOAT) return column->data;
+    int_to_double(tmp, column->data, n);
+    return tmp;
+}
+
+static const int64_t *column_i64(const ArrayKernels *kernels, const Column *column, int64_t *tmp, size_t n) {
+    if (!column->is_scalar) return column->data;
+    kernels->fill_i64(tmp, column->scalar.value.i_val, n);
+    return tmp;
+}
+
+static void set_vector(Column *column, VarType type) {
+    column->type = type;
+    column->is_scalar = false;
+    column->data = column->buffer;
+}
+
+// Operatore binario tra due colonne; il risultato prende il posto di left
+static void binary_column(Interpreter *interp, const ArrayKernels *kernels, Column *left, const Column *right,
+                          OperatorKind op, size_t n, void *tmp_a, void *tmp_b, int line_number) {
+    if (left->is_scalar && right->is_scalar) {
+        left->scalar = apply_binary_operator(interp, op, left->scalar, right->scalar, line_number);
+        left->type = left->scalar.type;
+        return;
+    }
+
+    bool numeric = left->type != TYPE_BOOL && right->type != TYPE_BOOL;
+    bool ints = left->type == TYPE_INT && right->type == TYPE_INT;
+    if (numeric && ints && (op == OPERATOR_ADD || op == OPERATOR_SUB)) {
+        const int64_t *a = column_i64(kernels, left, tmp_a, n), *b = column_i64(kernels, right, tmp_b, n);
+        bool ok = (op == OPERATOR_ADD ? kernels->add_i64 : kernels->sub_i64)(left->buffer, a, b, n);
+        if (!ok) handle_error(interp, "INTEGER OVERFLOW. ", line_number);
+        set_vector(left, TYPE_INT);
+        return;
+    }
+    if (numeric && ints && op == OPERATOR_MUL) {
+        const int64_t *a = column_i64(kernels, left, tmp_a, n), *b = column_i64(kernels, right, tmp_b, n);
+        int64_t *out = left->buffer;
+        bool overflow = false;
+        for (size_t i = 0; i < n; i++) overflow |= __builtin_mul_overflow(a[i], b[i], &out[i]);
+        if (overflow) handle_error(interp, "INTEGER OVERFLOW. ", line_number);
+        set_vector(left, TYPE_INT);
+        return;
+    }
+    // La divisione tra interi passa dal caso generico (quoziente esatto, come in CALC)
+    if (numeric && !ints && (op == OPERATOR_ADD || op == OPERATOR_SUB || op == OPERATOR_MUL || op == OPERATOR_DIV)) {
+        const double *a = column_f64(kernels, left, tmp_a, n), *b = column_f64(kernels, right, tmp_b, n);
+        if (op == OPERATOR_DIV) {
+            for (size_t i = 0; i < n; i++)
+                if (b[i] == 0.0) handle_error(interp, "DIVISION BY ZERO", line_number);
+        }
+        switch (op) {
+            case OPERATOR_ADD: kernels->add_f64(left->buffer, a, b, n); break;
+            case OPERATOR_SUB: kernels->sub_f64(left->buffer, a, b, n); break;
+            case OPERATOR_MUL: kernels->mul_f64(left->buffer, a, b, n); break;
+            default: kernels->div_f64(left->buffer, a, b, n); break;
+        }
+        set_vector(left, TYPE_FLOAT);
+        return;
+    }
+
+    // Caso generico: stessi operatori (e stessi errori) di CALC, un elemento alla volta. Solo la potenza
+    // tra interi cambia tipo da un elemento all'altro (FLOAT con esponente negativo): la colonna diventa FLOAT
+    VarType type = TYPE_INT;
+    for (size_t i = 0; i < n; i++) {
+        CalcResult value = apply_binary_operator(interp, op, column_get(left, i), column_get(right, i), line_number);
+        if (i == 0) type = value.type;
+        else if (value.type != type) {
+            if (type == TYPE_INT) promote_column(left, i);
+            if (value.type == TYPE_INT) value = (CalcResult){TYPE_FLOAT, {.f_val = (double)value.value.i_val}};
+            type = TYPE_FLOAT;
+        }
+        column_store(left, i, value);
+    }
+    set_vector(left, type);
+}
+
+static void unary_column(Interpreter *interp, Column *operand, OperatorKind op, size_t n, int line_number) {
+    if (operand->is_scalar) {
+        operand->scalar = apply_unary_operator(interp, op, operand->scalar, line_number);
+        operand->type = operand->scalar.type;
+        return;
+    }
+    VarType type = operand->type;
+    for (size_t i = 0; i < n; i++) {
+        CalcResult value = apply_unary_operator(interp, op, column_get(operand, i), line_number);
+        column_store(operand, i, value);
+        type = value.type;
+    }
+    set_vector(operand, type);
+}
+
+// Scrive il blocco calcolato in dst[base, base + n)
+static void store_column(Interpreter *interp, const ArrayKernels *kernels, Array *dst, const Column *column,
+                         size_t base, size_t n, int line_number) {
+    if (column->type == TYPE_BOOL || (dst->type == TYPE_INT && column->type != TYPE_INT))
+        handle_error(interp, "MAP RESULT DOES NOT MATCH ARRAY TYPE. ", line_number);
+
+    if (dst->type == TYPE_INT) {
+        if (column->is_scalar) kernels->fill_i64(dst->data.i + base, column->scalar.value.i_val, n);
+        else memmove(dst->data.i + base, column->data, n * sizeof(int64_t));
+    } else if (!column->is_scalar && column->type == TYPE_FLOAT) {
+        memmove(dst->data.f + base, column->data, n * sizeof(double));
+    } else {
+        column_f64(kernels, column, dst->data.f + base, n);
+    }
+}
+
+// dst[i] = espressione, dove ogni array vale il suo i-esimo elemento e gli scalari restano fissi
+void map_array(Interpreter *interp, Array *dst, const ExprOp *ops, size_t count, int line_number) {
+    const ArrayKernels *kernels = get_kernels();
+
+    // Controlli una volta sola: variabili dichiarate, tipi, lunghezze e profondità della pila
+    int depth = 0, max_depth = 0;
+    bool has_array = false;
+    for (size_t i = 0; i < count; i++) {
+        const ExprOp *op = &ops[i];
+        if (op->type == EXPR_VARIABLE) {
+            const Variable *var = &interp->stack[op->slot];
+            if (!var->is_declared) handle_error(interp, "VARIABLE NOT FOUND IN EXPRESSION", line_number);
+            if (is_array_type(var->type)) {
+                if (var->value.a_val->len != dst->len) handle_error(interp, "ARRAY SIZE MISMATCH. ", line_number);
+                has_array = true;
+            } else if (var->type != TYPE_INT && var->type != TYPE_FLOAT && var->type != TYPE_BOOL)
+                handle_error(interp, "UNSUPPORTED VARIABLE TYPE IN EXPRESSION", line_number);
+        }
+        if (op->type == EXPR_CONSTANT || op->type == EXPR_VARIABLE) depth++;
+        else if (op->type == EXPR_BINARY) depth--;
+        if (depth > max_depth) max_depth = depth;
+    }
+
+    // Nessun array nell'espressione: un solo valore per tutti gli elementi
+    if (!has_array) {
+        fill_array(interp, dst, evaluate_compiled(interp, ops, count, line_number), line_number);
+        return;
+    }
+
+    Column columns[EXPR_STACK_SIZE];
+    char *scratch = scratch_buffer(interp, (size_t)(max_depth + 2) * ARRAY_CHUNK * sizeof(int64_t));
+    for (int i = 0; i < max_depth; i++) columns[i].buffer = scratch + (size_t)i * ARRAY_CHUNK * sizeof(int64_t);
+    void *tmp_a = scratch + (size_t)max_depth * ARRAY_CHUNK * sizeof(int64_t);
+    void *tmp_b = scratch + (size_t)(max_depth + 1) * ARRAY_CHUNK * sizeof(int64_t);
+
+    for (size_t base = 0; base < dst->len; base += ARRAY_CHUNK) {
+        size_t n = dst->len - base < ARRAY_CHUNK ? dst->len - base : ARRAY_CHUNK;
+        int sp = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            const ExprOp *op = &ops[i];
+            switch (op->type) {
+                case EXPR_CONSTANT:
+                    columns[sp].is_scalar = true;
+                    columns[sp].scalar = op->value;
+                    columns[sp].type = op->value.type;
+                    sp++;
+                    break;
+                case EXPR_VARIABLE: {
+                    const Variable *var = &interp->stack[op->slot];
+                    Column *column = &columns[sp++];
+                    if (is_array_type(var->type)) {
+                        const Array *array = var->value.a_val;
+                        column->is_scalar = false;
+                        column->type = array->type;
+                        column->data = array->type == TYPE_INT ? (const void *)(array->data.i + base)
+                                                               : (const void *)(array->data.f + base);
+                    } else {
+                        column->is_scalar = true;
+                        column->type = var->type;
+                        column->scalar.type = var->type;
+                        if (var->type == TYPE_INT) column->scalar.value.i_val = var->value.i_val;
+                        else if (var->type == TYPE_FLOAT) column->scalar.value.f_val = var->value.f_val;
+                        else column->scalar.value.b_val = var->value.b_val;
+                    }
+                    break;
+                }
+                case EXPR_UNARY:
+                    unary_column(interp, &columns[sp - 1], op->op, n, line_number);
+                    break;
+                case EXPR_BINARY:
+                    sp--;
+                    binary_column(interp, kernels, &columns[sp - 1], &columns[sp], op->op, n, tmp_a, tmp_b, line_number);
+                    break;
+            }
+        }
+        store_column(interp, kernels, dst, &columns[0], base, n, line_number);
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef ARRAY_H
+#define ARRAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "helper_function-2.2.h"
+#include "calc_parser.h"
+
+// Allineamento dei buffer degli array (un registro AVX2)
+#define ARRAY_ALIGN 32
+
+// Numero massimo di elementi di un array
+#define ARRAY_MAX_LENGTH ((size_t)1 << 28)
+
+// Array di INT o FLOAT: elementi contigui e allineati
+typedef struct Array {
+    VarType type;   // tipo degli elementi: TYPE_INT o TYPE_FLOAT
+    size_t len;
+    union {
+        int64_t *i;
+        double *f;
+        void *raw;
+    } data;
+} Array;
+
+// Riduzioni su un intero array
+typedef enum {
+    REDUCE_SUM, REDUCE_MIN, REDUCE_MAX, REDUCE_MEAN
+} ReduceKind;
+
+// Dichiarazione delle funzioni degli array
+Array *new_array(VarType type, size_t len);
+void free_array(Array *array);
+bool is_array_type(VarType type);
+void fill_array(Interpreter *interp, Array *array, CalcResult value, int line_number);
+void map_array(Interpreter *interp, Array *dst, const ExprOp *ops, size_t count, int line_number);
+CalcResult reduce_array(Interpreter *interp, const Array *array, ReduceKind kind, int line_number);
+CalcResult dot_arrays(Interpreter *interp, const Array *a, const Array *b, int line_number);
+void append_array(TextBuffer *out, const Array *array, int64_t index);
+const char *get_array_kernels_name(void);
+
+#endif
@@ -0,0 +1,23 @@
+#!/bin/sh
+# Compila libnoobie.a e libnoobie.so: tutti i sorgenti dell'interprete tranne il main.
+# L'API pubblica è in libnoobie-2.2.h.
+#
+# Uso: sh build_libnoobie.sh [cartella_di_output]   (da eseguire nella cartella 2.2)
+# Variabili d'ambiente: CC (default gcc), CFLAGS (default -O2)
+
+set -e
+OUT=${1:-.}
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:--O2}
+OBJ=$(mktemp -d)
+trap 'rm -rf "$OBJ"' EXIT
+
+for src in $(ls *.c | grep -v '^noobie-2_2\.c$') ../calc_parser.c; do
+    $CC $CFLAGS -fPIC -I. -I.. -c "$src" -o "$OBJ/$(basename "$src" .c).o"
+done
+
+mkdir -p "$OUT"
+rm -f "$OUT/libnoobie.a"
+ar rcs "$OUT/libnoobie.a" "$OBJ"/*.o
+$CC -shared -o "$OUT/libnoobie.so" "$OBJ"/*.o -lm -pthread
+echo "built $OUT/libnoobie.a $OUT/libnoobie.so"
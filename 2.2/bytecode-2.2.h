@@ -0,0 +1,124 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "helper_function-2.2.h"
+#include "calc_parser.h"
+#include "scan-2.2.h"
+
+struct JitCache;
+
+// Offset nullo nel pool delle stringhe (o template assente)
+#define NO_TEXT UINT32_MAX
+
+// Codici operativi delle istruzioni
+typedef enum {
+    OP_CLEAR, OP_EXIT, OP_LINE, OP_CALC, OP_SET, OP_SAY, OP_LISTEN, OP_INCREMENT, OP_DECREMENT, OP_ERROR,
+    OP_ARRAY, OP_FILL, OP_MAP, OP_SUM, OP_MIN, OP_MAX, OP_MEAN, OP_DOT, OP_BRANCH, OP_JUMP,
+    OP_WHILE, OP_REPEAT, OP_NEXT
+} OpCode;
+
+// Istruzione compilata: gli operandi sono già risolti (slot, letterali, testi nel pool)
+typedef struct Instruction {
+    OpCode op;
+    int line;       // riga del sorgente, per i messaggi di errore
+    int slot;       // variabile di destinazione (SET, LISTEN, INCREMENT, DECREMENT), array o contatore di REPEAT
+    int operand;    // secondo array (DOT)
+    int target;     // variabile che riceve il risultato di una riduzione (-1 = stampa)
+    VarType type;   // tipo dichiarato (SET, LISTEN, ARRAY)
+    bool is_const;
+    uint32_t text;  // messaggio, prompt o valore STR nel pool
+    uint32_t expr;  // prima operazione RPN dell'espressione compilata (CALC, ARRAY, FILL, MAP)
+    uint32_t expr_len;
+    uint32_t tpl;   // primo segmento del template (SAY, EXIT, LISTEN, LINE)
+    uint32_t tpl_len;
+    uint32_t jump;  // istruzione a cui saltare: uscita da IF/WHILE/REPEAT, fine del ramo prima di ELSE, inizio del ciclo (ENDO)
+    Value imm;      // valore letterale già convertito (SET, LINE statico)
+} Instruction;
+
+// Segmento di un template di interpolazione
+typedef enum {
+    SEG_TEXT,   // testo letterale con gli escape già risolti
+    SEG_VALUE,  // @nome: valore della variabile
+    SEG_TYPE,   // #nome: tipo della variabile
+    SEG_ELEMENT // @nome[i]: elemento di un array
+} SegmentKind;
+
+typedef struct Segment {
+    SegmentKind kind;
+    int slot;       // SEG_VALUE, SEG_TYPE, SEG_ELEMENT
+    int index;      // SEG_ELEMENT: slot della variabile indice, -1 se l'indice è il letterale in len
+    uint32_t text;  // SEG_TEXT: offset nel pool; SEG_ELEMENT: testo "[...]" del sorgente
+    uint32_t len;
+} Segment;
+
+
+// Programma compilato: array piatto di istruzioni più un pool di stringhe e uno di espressioni
+typedef struct Program {
+    Instruction *code;
+    size_t count;
+    size_t capacity;
+    char *pool;
+    size_t pool_len;
+    size_t pool_cap;
+    ExprCode exprs;
+    Segment *segments;
+    size_t segment_count;
+    size_t segment_cap;
+    void *image;        // se presente il programma è un'immagine .nobc mappata in sola lettura
+    size_t image_size;
+    struct JitCache *jit; // codice nativo delle espressioni calde (--jit), NULL = solo interprete
+} Program;
+
+// Blocchi chiusi da ENDO
+typedef enum {
+    BLOCK_IF, BLOCK_WHILE, BLOCK_REPEAT
+} BlockKind;
+
+// Blocco ancora aperto: l'istruzione che lo apre e quella il cui salto verrà risolto da
+// ELSE o ENDO (l'apertura stessa, oppure il salto emesso da ELSE)
+typedef struct OpenBlock {
+    BlockKind kind;
+    uint32_t start;
+    uint32_t pending;
+    int line;
+} OpenBlock;
+
+// Stato del front end tra una riga e l'altra: buffer riusati, commento multilinea e blocchi aperti
+typedef struct LineCompiler {
+    int n_line;                 // righe lette finora
+    bool in_multiline_comment;
+    char *copy;                 // copia tokenizzata della riga
+    size_t copy_cap;
+    char **tokens;
+    size_t token_cap;
+    TextBuffer text;            // argomenti di SAY/LISTEN riscritti come template
+    LineMarks marks;            // caratteri speciali della riga, poi solo le sue virgolette
+    OpenBlock *blocks;          // IF e cicli aperti, dal più esterno al più interno
+    size_t block_count;
+    size_t block_cap;
+} LineCompiler;
+
+// Dichiarazione delle funzioni del compilatore e della VM
+void init_program(Program *program);
+void free_program(Program *program);
+void reset_program(Program *program);
+uint32_t add_string(Program *program, const char *str, size_t len);
+const char *get_string(const Program *program, uint32_t offset);
+void compile_file(Interpreter *interp, FILE *file, Program *program);
+void init_line_compiler(LineCompiler *lc);
+void free_line_compiler(LineCompiler *lc);
+void compile_source_line(Interpreter *interp, LineCompiler *lc, Program *program, char *line, size_t len);
+void finish_source(LineCompiler *lc, Program *program);
+void compile_template(Interpreter *interp, Program *program, const char *text, uint32_t *first, uint32_t *count);
+void render_template(Interpreter *interp, const Program *program, uint32_t first, uint32_t count, TextBuffer *out);
+const char *parse_line_arguments(char *text, int *count, const char **symbol);
+bool execute_program(Interpreter *interp, const Program *program);
+bool execute_single(Interpreter *interp, const Program *program, const Instruction *in);
+void step_variable(Interpreter *interp, int slot, int delta, int line_number);
+const char *get_opcode_name(OpCode op);
+
+#endif
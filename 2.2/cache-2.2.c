@@ -0,0 +1,359 @@
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "cache-2.2.h"
+
+// -------------------------- IMMAGINE .nobc --------------------------
+// File accanto alla sorgente (script.nob -> script.nobc): intestazione, poi istruzioni, pool
+// delle stringhe, operazioni RPN, segmenti dei template e nomi delle variabili in ordine di slot.
+// Tutti i riferimenti sono offset o indici, quindi l'immagine viene usata direttamente dopo mmap.
+
+#define NOBC_MAGIC "NOBC"
+#define NOBC_BYTE_ORDER 0x01020304u
+#define NOBC_ALIGN 16
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t byte_order;          // rifiuta immagini scritte su macchine con endianness diversa
+    uint32_t instruction_size;    // le dimensioni delle strutture rilevano layout incompatibili
+    uint32_t expr_op_size;
+    uint32_t segment_size;
+    uint64_t source_hash;
+    uint64_t source_size;
+    uint64_t code_offset, code_count;
+    uint64_t pool_offset, pool_len;
+    uint64_t expr_offset, expr_count;
+    uint64_t segment_offset, segment_count;
+    uint64_t names_offset, names_len, name_count;
+    uint64_t image_size;
+} NobcHeader;
+
+// Percorso dell'immagine: la sorgente con il suffisso "c" (o ".nobc" se non termina in .nob)
+static char *cache_path(const char *filename) {
+    size_t len = strlen(filename);
+    char *path = malloc(len + 6);
+    if (!path) return NULL;
+    memcpy(path, filename, len + 1);
+    if (len >= 4 && strcmp(filename + len - 4, ".nob") == 0) strcat(path, "c");
+    else strcat(path, ".nobc");
+    return path;
+}
+
+// Hash FNV-1a a 64 bit
+static uint64_t hash_bytes(const unsigned char *data, size_t len) {
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < len; i++) {
+        h ^= data[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// Calcola l'identità della sorgente leggendola tramite mmap
+static SourceKey source_key(const char *filename) {
+    SourceKey key = {0, 0, false};
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return key;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+        key.size = (uint64_t)info.st_size;
+        if (key.size == 0) {
+            key.hash = hash_bytes(NULL, 0);
+            key.valid = true;
+        } else {
+            void *data = mmap(NULL, key.size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                key.hash = hash_bytes(data, key.size);
+                key.valid = true;
+                munmap(data, key.size);
+            }
+        }
+    }
+    close(fd);
+    return key;
+}
+
+static uint64_t align_up(uint64_t value) {
+    return (value + NOBC_ALIGN - 1) & ~(uint64_t)(NOBC_ALIGN - 1);
+}
+
+// -------------------------- VALIDAZIONE --------------------------
+// Un'immagine corrotta non deve mai far leggere fuori dai pool: ogni riferimento viene controllato.
+
+static bool range_ok(const NobcHeader *h, uint64_t offset, uint64_t count, uint64_t size) {
+    return offset % NOBC_ALIGN == 0 && offset <= h->image_size && count <= (h->image_size - offset) / (size ? size : 1);
+}
+
+static bool slot_ok(const NobcHeader *h, int slot) {
+    return slot >= 0 && (uint64_t)slot < h->name_count;
+}
+
+static bool text_ok(const NobcHeader *h, uint32_t text) {
+    return text != NO_TEXT && text < h->pool_len;
+}
+
+// Letterale STR di lunghezza nota: il '\0' finale deve stare nel pool
+static bool string_ok(const NobcHeader *h, uint32_t text, uint32_t len) {
+    return text_ok(h, text) && (uint64_t)text + len < h->pool_len;
+}
+
+static bool template_ok(const NobcHeader *h, uint32_t first, uint32_t count) {
+    return first != NO_TEXT && (uint64_t)first + count <= h->segment_count;
+}
+
+static bool value_type_ok(VarType type) {
+    return type == TYPE_INT || type == TYPE_FLOAT || type == TYPE_BOOL;
+}
+
+// L'espressione deve essere RPN ben formata: la VM non ricontrolla la pila
+static bool expression_ok(const NobcHeader *h, const ExprOp *ops, uint32_t first, uint32_t count) {
+    if (count == 0 || (uint64_t)first + count > h->expr_count) return false;
+
+    int depth = 0;
+    for (uint32_t i = first; i < first + count; i++) {
+        const ExprOp *op = &ops[i];
+        switch (op->type) {
+            case EXPR_CONSTANT:
+                if (!value_type_ok(op->value.type)) return false;
+                depth++;
+                break;
+            case EXPR_VARIABLE:
+                if (!slot_ok(h, op->slot)) return false;
+                depth++;
+                break;
+            case EXPR_UNARY:
+                if (depth < 1 || op->op <= OPERATOR_NONE || op->op > OPERATOR_NOT) return false;
+                break;
+            case EXPR_BINARY:
+                if (depth < 2 || op->op <= OPERATOR_NONE || op->op > OPERATOR_NOT) return false;
+                depth--;
+                break;
+            default:
+                return false;
+        }
+        if (depth > EXPR_STACK_SIZE) return false;
+    }
+    return depth == 1;
+}
+
+static bool instruction_ok(const NobcHeader *h, const Instruction *in, const ExprOp *ops) {
+    switch (in->op) {
+        case OP_CLEAR:
+            return true;
+        case OP_EXIT:
+            return in->tpl == NO_TEXT || template_ok(h, in->tpl, in->tpl_len);
+        case OP_LINE: // forma statica: simbolo e numero di ripetizioni, che run_line passa come int
+            if (in->text != NO_TEXT) return text_ok(h, in->text) && in->imm.i_val >= 0 && in->imm.i_val <= INT_MAX;
+            return template_ok(h, in->tpl, in->tpl_len);
+        case OP_CALC:
+            return expression_ok(h, ops, in->expr, in->expr_len);
+        case OP_SET:
+            return slot_ok(h, in->slot) && in->type <= TYPE_BOOL && (in->type != TYPE_STR || string_ok(h, in->text, in->imm.s_val.len));
+        case OP_SAY:
+            return template_ok(h, in->tpl, in->tpl_len);
+        case OP_LISTEN:
+            return slot_ok(h, in->slot) && in->type <= TYPE_BOOL && template_ok(h, in->tpl, in->tpl_len);
+        case OP_INCREMENT:
+        case OP_DECREMENT:
+            return slot_ok(h, in->slot);
+        case OP_ERROR:
+            return text_ok(h, in->text);
+        case OP_ARRAY:
+            return slot_ok(h, in->slot) && (in->type == TYPE_ARRAY_INT || in->type == TYPE_ARRAY_FLOAT) &&
+                   expression_ok(h, ops, in->expr, in->expr_len);
+        case OP_FILL:
+        case OP_MAP:
+            return slot_ok(h, in->slot) && expression_ok(h, ops, in->expr, in->expr_len);
+        case OP_DOT:
+            if (!slot_ok(h, in->operand)) return false;
+            // fallthrough
+        case OP_SUM:
+        case OP_MIN:
+        case OP_MAX:
+        case OP_MEAN:
+            return slot_ok(h, in->slot) && (in->target == -1 || slot_ok(h, in->target));
+        case OP_REPEAT:
+            if (!slot_ok(h, in->slot)) return false;
+            // fallthrough
+        case OP_BRANCH:
+        case OP_WHILE:
+            if (!expression_ok(h, ops, in->expr, in->expr_len)) return false;
+            // fallthrough
+        case OP_JUMP:
+            return in->jump <= h->code_count; // code_count = fine del programma
+        case OP_NEXT:
+            return (in->slot == -1 || slot_ok(h, in->slot)) && in->jump <= h->code_count;
+        default:
+            return false;
+    }
+}
+
+static bool image_ok(const NobcHeader *h, const char *image, const SourceKey *key) {
+    if (memcmp(h->magic, NOBC_MAGIC, 4) != 0 || h->version != NOBC_VERSION || h->byte_order != NOBC_BYTE_ORDER) return false;
+    if (h->instruction_size != sizeof(Instruction) || h->expr_op_size != sizeof(ExprOp) || h->segment_size != sizeof(Segment))
+        return false;
+    if (h->source_hash != key->hash || h->source_size != key->size) return false;
+
+    if (!range_ok(h, h->code_offset, h->code_count, sizeof(Instruction)) ||
+        !range_ok(h, h->pool_offset, h->pool_len, 1) ||
+        !range_ok(h, h->expr_offset, h->expr_count, sizeof(ExprOp)) ||
+        !range_ok(h, h->segment_offset, h->segment_count, sizeof(Segment)) ||
+        !range_ok(h, h->names_offset, h->names_len, 1))
+        return false;
+    if (h->pool_len > NO_TEXT || h->segment_count > NO_TEXT || h->expr_count > NO_TEXT) return false;
+    if (h->pool_len && image[h->pool_offset + h->pool_len - 1] != '\0') return false;
+    if (h->names_len && image[h->names_offset + h->names_len - 1] != '\0') return false;
+
+    const Segment *segments = (const Segment *)(image + h->segment_offset);
+    for (uint64_t i = 0; i < h->segment_count; i++) {
+        const Segment *seg = &segments[i];
+        if (seg->kind == SEG_TEXT) {
+            if ((uint64_t)seg->text + seg->len >= h->pool_len) return false; // testo seguito dal suo '\0'
+        } else if (seg->kind == SEG_ELEMENT) {
+            if (!slot_ok(h, seg->slot) || (seg->index != -1 && !slot_ok(h, seg->index)) || !text_ok(h, seg->text)) return false;
+        } else if ((seg->kind != SEG_VALUE && seg->kind != SEG_TYPE) || !slot_ok(h, seg->slot))
+            return false;
+    }
+
+    const Instruction *code = (const Instruction *)(image + h->code_offset);
+    const ExprOp *ops = (const ExprOp *)(image + h->expr_offset);
+    for (uint64_t i = 0; i < h->code_count; i++)
+        if (!instruction_ok(h, &code[i], ops)) return false;
+    return true;
+}
+
+// -------------------------- LETTURA --------------------------
+
+// Carica l'immagine valida per la sorgente, se esiste. In ogni caso key identifica la sorgente
+// corrente, così il chiamante può salvare una nuova immagine dopo la compilazione.
+bool load_program_cache(Interpreter *interp, const char *filename, Program *program, SourceKey *key) {
+    *key = source_key(filename);
+    if (!key->valid || interp->n != 0) return false; // gli slot dell'immagine partono da zero
+
+    char *path = cache_path(filename);
+    if (!path) return false;
+    int fd = open(path, O_RDONLY);
+    free(path);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(NobcHeader)) {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)info.st_size;
+    char *image = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) return false;
+
+    const NobcHeader *h = (const NobcHeader *)image;
+    if (h->image_size != size || !image_ok(h, image, key)) {
+        munmap(image, size);
+        return false;
+    }
+
+    // I nomi vengono reinternati nello stesso ordine: ottengono gli stessi slot della compilazione
+    const char *name = image + h->names_offset;
+    for (uint64_t i = 0; i < h->name_count; i++) {
+        if (name >= image + h->names_offset + h->names_len) {
+            munmap(image, size);
+            return false;
+        }
+        intern_variable(interp, name);
+        name += strlen(name) + 1;
+    }
+    if ((uint64_t)interp->n != h->name_count) { // nomi duplicati: immagine non valida
+        munmap(image, size);
+        return false;
+    }
+
+    init_program(program);
+    program->code = (Instruction *)(image + h->code_offset);
+    program->count = h->code_count;
+    program->pool = image + h->pool_offset;
+    program->pool_len = h->pool_len;
+    program->exprs.ops = (ExprOp *)(image + h->expr_offset);
+    program->exprs.count = h->expr_count;
+    program->segments = (Segment *)(image + h->segment_offset);
+    program->segment_count = h->segment_count;
+    program->image = image;
+    program->image_size = size;
+    return true;
+}
+
+// -------------------------- SCRITTURA --------------------------
+
+static bool write_section(FILE *out, const void *data, size_t len, uint64_t offset) {
+    static const char zeros[NOBC_ALIGN] = {0};
+    long position = ftell(out);
+    if (position < 0 || (uint64_t)position > offset) return false;
+    if (fwrite(zeros, 1, offset - (uint64_t)position, out) != offset - (uint64_t)position) return false;
+    return len == 0 || fwrite(data, 1, len, out) == len;
+}
+
+// Salva l'immagine accanto alla sorgente (file temporaneo + rename, così i lettori non vedono
+// mai un'immagine a metà). Se la cartella non è scrivibile la cache viene semplicemente saltata.
+void save_program_cache(const Interpreter *interp, const char *filename, const Program *program, const SourceKey *key) {
+    if (!key->valid) return;
+
+    TextBuffer names = {0};
+    for (int i = 0; i < interp->n; i++) text_append(&names, interp->stack[i].name, strlen(interp->stack[i].name) + 1);
+
+    NobcHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, NOBC_MAGIC, 4);
+    h.version = NOBC_VERSION;
+    h.byte_order = NOBC_BYTE_ORDER;
+    h.instruction_size = sizeof(Instruction);
+    h.expr_op_size = sizeof(ExprOp);
+    h.segment_size = sizeof(Segment);
+    h.source_hash = key->hash;
+    h.source_size = key->size;
+    h.code_count = program->count;
+    h.pool_len = program->pool_len;
+    h.expr_count = program->exprs.count;
+    h.segment_count = program->segment_count;
+    h.names_len = names.len;
+    h.name_count = (uint64_t)interp->n;
+
+    h.code_offset = align_up(sizeof(NobcHeader));
+    h.pool_offset = align_up(h.code_offset + h.code_count * sizeof(Instruction));
+    h.expr_offset = align_up(h.pool_offset + h.pool_len);
+    h.segment_offset = align_up(h.expr_offset + h.expr_count * sizeof(ExprOp));
+    h.names_offset = align_up(h.segment_offset + h.segment_count * sizeof(Segment));
+    h.image_size = h.names_offset + h.names_len;
+
+    char *path = cache_path(filename);
+    char *temp = path ? malloc(strlen(path) + 8) : NULL;
+    int fd = -1;
+    if (temp) {
+        sprintf(temp, "%s.XXXXXX", path);
+        fd = mkstemp(temp);
+    }
+    FILE *out = fd >= 0 ? fdopen(fd, "wb") : NULL;
+
+    bool ok = out &&
+        write_section(out, &h, sizeof(h), 0) &&
+        write_section(out, program->code, h.code_count * sizeof(Instruction), h.code_offset) &&
+        write_section(out, program->pool, h.pool_len, h.pool_offset) &&
+        write_section(out, program->exprs.ops, h.expr_count * sizeof(ExprOp), h.expr_offset) &&
+        write_section(out, program->segments, h.segment_count * sizeof(Segment), h.segment_offset) &&
+        write_section(out, names.data, h.names_len, h.names_offset);
+
+    if (out) ok = fclose(out) == 0 && ok;
+    else if (fd >= 0) close(fd);
+    if (ok) ok = chmod(temp, 0644) == 0 && rename(temp, path) == 0;
+    if (!ok && fd >= 0) unlink(temp);
+
+    free(names.data);
+    free(temp);
+    free(path);
+}
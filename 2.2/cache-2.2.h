@@ -0,0 +1,25 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "helper_function-2.2.h"
+#include "bytecode-2.2.h"
+
+// Versione del formato .nobc: da incrementare a ogni modifica di Instruction, ExprOp, Segment
+// o della semantica della compilazione
+#define NOBC_VERSION 8
+
+// Identità della sorgente da cui è stata compilata un'immagine
+typedef struct {
+    uint64_t hash;  // FNV-1a a 64 bit del contenuto
+    uint64_t size;
+    bool valid;     // false se la sorgente non si può leggere
+} SourceKey;
+
+// Dichiarazione delle funzioni della cache dei programmi compilati
+bool load_program_cache(Interpreter *interp, const char *filename, Program *program, SourceKey *key);
+void save_program_cache(const Interpreter *interp, const char *filename, const Program *program, const SourceKey *key);
+
+#endif
@@ -0,0 +1,775 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <sys/mman.h>
+
+#include "bytecode-2.2.h"
+#include "keywords-2.2.h"
+#include "scan-2.2.h"
+#include "jit-2.2.h"
+
+// -------------------------- GESTIONE DEL PROGRAMMA --------------------------
+
+// Inizializza un programma vuoto
+void init_program(Program *program) {
+    memset(program, 0, sizeof(*program));
+}
+
+// Libera istruzioni e pool delle stringhe
+void free_program(Program *program) {
+    free_jit_cache(program->jit);
+    if (program->image) { // i pool puntano dentro la mappatura
+        munmap(program->image, program->image_size);
+        init_program(program);
+        return;
+    }
+    free(program->code);
+    free(program->pool);
+    free_expr_code(&program->exprs);
+    free(program->segments);
+    init_program(program);
+}
+
+// Svuota il programma mantenendo la capacità dei buffer (esecuzione in streaming)
+void reset_program(Program *program) {
+    program->count = 0;
+    program->pool_len = 0;
+    program->exprs.count = 0;
+    program->segment_count = 0;
+    clear_jit_cache(program->jit); // le stesse posizioni ospiteranno altre espressioni
+}
+
+// Copia una stringa nel pool e ne restituisce l'offset
+uint32_t add_string(Program *program, const char *str, size_t len) {
+    if (program->pool_len + len + 1 > program->pool_cap) {
+        size_t cap = program->pool_cap ? program->pool_cap : 256;
+        while (program->pool_len + len + 1 > cap) cap *= 2;
+        char *pool = realloc(program->pool, cap);
+        if (!pool) handle_error(NULL, "OUT OF MEMORY. ", -1);
+        program->pool = pool;
+        program->pool_cap = cap;
+    }
+
+    uint32_t offset = (uint32_t)program->pool_len;
+    memcpy(program->pool + offset, str, len);
+    program->pool[offset + len] = '\0';
+    program->pool_len += len + 1;
+    return offset;
+}
+
+// Restituisce la stringa salvata all'offset indicato
+const char *get_string(const Program *program, uint32_t offset) {
+    return program->pool + offset;
+}
+
+// Aggiunge un'istruzione vuota in coda al programma
+static Instruction *emit(Program *program, OpCode op, int line_number) {
+    if (program->count == program->capacity) {
+        size_t cap = program->capacity ? program->capacity * 2 : 64;
+        Instruction *code = realloc(program->code, cap * sizeof(Instruction));
+        if (!code) handle_error(NULL, "OUT OF MEMORY. ", line_number);
+        program->code = code;
+        program->capacity = cap;
+    }
+
+    Instruction *in = &program->code[program->count++];
+    memset(in, 0, sizeof(*in));
+    in->op = op;
+    in->line = line_number;
+    in->slot = -1;
+    in->operand = -1;
+    in->target = -1;
+    in->text = NO_TEXT;
+    return in;
+}
+
+// Un errore di compilazione diventa un'istruzione: scatta solo quando l'esecuzione arriva a quella riga
+static void emit_error(Program *program, const char *message, int line_number) {
+    Instruction *in = emit(program, OP_ERROR, line_number);
+    in->text = add_string(program, message, strlen(message));
+}
+
+// -------------------------- ANALISI DEGLI ARGOMENTI --------------------------
+
+// Prima virgoletta della riga in posizione >= from, dalle posizioni già trovate da scan_line
+static const char *next_quote(const LineCompiler *lc, const char *line, const char *from) {
+    size_t target = (size_t)(from - line), lo = 0, hi = lc->marks.count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (lc->marks.pos[mid] < target) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < lc->marks.count ? line + lc->marks.pos[lo] : NULL;
+}
+
+// Converte i segmenti di SAY/LISTEN ("testo" oppure nome) nella forma interpolabile "testo@nome"
+static bool split_segments(const LineCompiler *lc, const char *line, const char *p, TextBuffer *out, bool all_segments) {
+    out->len = 0;
+    text_append(out, "", 0);
+
+    do {
+        while (*p == ' ') p++;
+
+        if (*p == '"') {
+            const char *start = ++p;
+            p = next_quote(lc, line, p);
+            if (!p) return false; // virgolette non chiuse
+            text_append(out, start, p - start);
+            p++; // salta la chiusura
+        } else if (*p) {
+            const char *start = p;
+            while (*p && !isspace((unsigned char)*p)) p++;
+            text_append(out, "@", 1);
+            text_append(out, start, p - start);
+        } else
+            break; // niente da leggere
+    } while (all_segments);
+
+    return true;
+}
+
+// Restituisce il punto della riga originale subito dopo il token indicato
+static char *after_token(char *line, const char *line_copy, const char *token) {
+    return line + (token - line_copy) + strlen(token);
+}
+
+// Salta gli spazi iniziali
+static char *skip_spaces(char *p) {
+    while (*p == ' ') p++;
+    return p;
+}
+
+// -------------------------- COMPILAZIONE DEI COMANDI --------------------------
+
+static void compile_set(Interpreter *interp, Program *program, char **tokens, int t, int n_line) {
+    bool is_const = false;
+    const char *type_str, *name, *value = NULL;
+
+    if (t >= 4 && lookup_keyword(tokens[1], strlen(tokens[1])) == KW_CONST) {
+        is_const = true;
+        type_str = tokens[2];
+        name = tokens[3];
+        if (t == 5) value = tokens[4];
+    } else if (t >= 3) {
+        type_str = tokens[1];
+        name = tokens[2];
+        if (t == 4) value = tokens[3];
+    } else {
+        emit_error(program, "SET REQUIRES AT LEAST TYPE AND VARIABLE NAME. ", n_line);
+        return;
+    }
+
+    VarType type = get_type_from_string(type_str);
+    if (type == TYPE_UNKNOW) {
+        emit_error(program, "UNKNOWN TYPE IN SET. ", n_line);
+        return;
+    }
+    if (is_reserved_keyword(name)) {
+        emit_error(program, "VARIABLE NAME CAN NOT BE A RESERVED KEYWORDS. ", n_line);
+        return;
+    }
+
+    int slot = intern_variable(interp, name);
+
+    // Il letterale viene convertito una sola volta qui, non a ogni esecuzione
+    Value imm = {0};
+    const char *error = NULL;
+    if (type == TYPE_STR) {
+        if (!value) value = "";
+    } else if ((error = parse_value(value, type, &imm))) {
+        emit_error(program, error, n_line);
+        return;
+    }
+
+    Instruction *in = emit(program, OP_SET, n_line);
+    in->slot = slot;
+    in->type = type;
+    in->is_const = is_const;
+    in->imm = imm;
+    if (type == TYPE_STR) {
+        // La lunghezza del letterale viaggia con l'istruzione: la VM non deve ricalcolarla
+        in->imm.s_val.len = (uint32_t)strlen(value);
+        in->text = add_string(program, value, in->imm.s_val.len);
+    }
+}
+
+static void compile_listen(Interpreter *interp, Program *program, LineCompiler *lc, char *line, int t, int n_line) {
+    char **tokens = lc->tokens;
+    if (t < 3) {
+        emit_error(program, "LISTEN REQUIRES AT LEAST TYPE. ", n_line);
+        return;
+    }
+
+    VarType type = get_type_from_string(tokens[1]);
+    if (type == TYPE_UNKNOW) {
+        emit_error(program, "UNKNOWN TYPE IN LISTEN. ", n_line);
+        return;
+    }
+
+    // Se è presente un nome variabile, lo usiamo; altrimenti "listened"
+    const char *var_name = "listened";
+    int prompt_index = 2;
+    if (tokens[2][0] != '"' && t >= 4) {
+        var_name = tokens[2];
+        prompt_index = 3;
+    }
+
+    if (is_reserved_keyword(var_name)) {
+        emit_error(program, "VARIABLE NAME CAN NOT BE A RESERVED KEYWORDS. ", n_line);
+        return;
+    }
+
+    int slot = intern_variable(interp, var_name);
+
+    if (!split_segments(lc, line, after_token(line, lc->copy, tokens[prompt_index - 1]), &lc->text, true)) {
+        emit_error(program, "MISSING CLOSING QUOTE IN LISTEN PROMPT. ", n_line);
+        return;
+    }
+
+    Instruction *in = emit(program, OP_LISTEN, n_line);
+    in->slot = slot;
+    in->type = type;
+    compile_template(interp, program, lc->text.data, &in->tpl, &in->tpl_len);
+}
+
+// Con soli letterali conteggio e motivo vengono risolti qui; altrimenti resta il template
+static void compile_line_command(Interpreter *interp, Program *program, const char *args, int n_line) {
+    uint32_t first, count;
+    compile_template(interp, program, args, &first, &count);
+
+    for (uint32_t i = first; i < first + count; i++) {
+        if (program->segments[i].kind != SEG_TEXT) {
+            Instruction *in = emit(program, OP_LINE, n_line);
+            in->tpl = first;
+            in->tpl_len = count;
+            return;
+        }
+    }
+
+    TextBuffer text = {0};
+    text_append(&text, "", 0);
+    render_template(interp, program, first, count, &text);
+    program->segment_count = first;
+
+    int repeat = 0;
+    const char *symbol;
+    const char *error = parse_line_arguments(text.data, &repeat, &symbol);
+    if (error) {
+        emit_error(program, error, n_line);
+    } else {
+        Instruction *in = emit(program, OP_LINE, n_line);
+        in->imm.i_val = repeat;
+        in->text = add_string(program, symbol, strlen(symbol));
+    }
+    free(text.data);
+}
+
+// Accoda il codice RPN dell'espressione; false (con l'istruzione d'errore già emessa) se non è valida
+static bool add_expression(Interpreter *interp, Program *program, const char *expression, uint32_t *first, uint32_t *count, int n_line) {
+    size_t start = program->exprs.count;
+    const char *error = compile_expression(interp, expression, &program->exprs);
+    if (error) {
+        emit_error(program, error, n_line);
+        return false;
+    }
+    *first = (uint32_t)start;
+    *count = (uint32_t)(program->exprs.count - start);
+    return true;
+}
+
+// L'espressione viene analizzata una volta sola: l'istruzione conserva il suo codice RPN
+static void compile_calc(Interpreter *interp, Program *program, const char *expression, int n_line) {
+    uint32_t first, count;
+    if (!add_expression(interp, program, expression, &first, &count, n_line)) return;
+
+    Instruction *in = emit(program, OP_CALC, n_line);
+    in->expr = first;
+    in->expr_len = count;
+}
+
+// -------------------------- BLOCCHI IF, WHILE E REPEAT --------------------------
+
+static const char *block_names[] = {"IF", "WHILE", "REPEAT"};
+
+// Blocco più interno, NULL se non ce ne sono di aperti
+static OpenBlock *innermost_block(LineCompiler *lc) {
+    return lc->block_count ? &lc->blocks[lc->block_count - 1] : NULL;
+}
+
+// IF <condizione> DO, WHILE <condizione> DO, REPEAT <volte> DO: l'espressione è compilata
+// come CALC e l'istruzione salta oltre ENDO quando il corpo non va eseguito. Il blocco si
+// apre anche se la riga è errata, così ELSE ed ENDO successivi trovano comunque il loro inizio
+static void compile_block(Interpreter *interp, Program *program, LineCompiler *lc, BlockKind kind, char *line,
+                          const char *line_copy, char **tokens, int t, int n_line) {
+    if (lc->block_count == lc->block_cap) {
+        size_t cap = lc->block_cap ? lc->block_cap * 2 : 8;
+        OpenBlock *blocks = realloc(lc->blocks, cap * sizeof(OpenBlock));
+        if (!blocks) handle_error(NULL, "OUT OF MEMORY. ", n_line);
+        lc->blocks = blocks;
+        lc->block_cap = cap;
+    }
+    uint32_t start = (uint32_t)program->count;
+    lc->blocks[lc->block_count++] = (OpenBlock){kind, start, start, n_line};
+
+    if (t < 3 || lookup_keyword(tokens[t - 1], strlen(tokens[t - 1])) != KW_DO) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%s STATEMENT MUST END WITH DO. ", block_names[kind]);
+        emit_error(program, msg, n_line);
+        return;
+    }
+    line[tokens[t - 1] - line_copy] = '\0'; // l'espressione è tutto ciò che sta prima di DO
+    char *expression = skip_spaces(after_token(line, line_copy, tokens[0]));
+
+    uint32_t first, count;
+    if (!add_expression(interp, program, expression, &first, &count, n_line)) return;
+    static const OpCode ops[] = {OP_BRANCH, OP_WHILE, OP_REPEAT};
+    Instruction *in = emit(program, ops[kind], n_line);
+    in->expr = first;
+    in->expr_len = count;
+    if (kind == BLOCK_REPEAT) {
+        // Il contatore è una variabile nascosta: lo spazio nel nome la rende irraggiungibile dal sorgente.
+        // Un solo slot per profondità di annidamento, così anche uno script letto da stdin ne usa pochi
+        char name[MAX_VAR_NAME];
+        snprintf(name, sizeof(name), " REPEAT %zu", lc->block_count - 1);
+        in->slot = intern_variable(interp, name);
+    }
+}
+
+// ELSE: il ramo vero salta oltre ENDO, il caso falso riparte dall'istruzione successiva
+static void compile_else(Program *program, LineCompiler *lc, int t, int n_line) {
+    OpenBlock *block = innermost_block(lc);
+    if (!block || block->kind != BLOCK_IF) {
+        emit_error(program, "ELSE WITHOUT MATCHING IF. ", n_line);
+        return;
+    }
+    if (t > 1) {
+        emit_error(program, "ELSE DOES NOT TAKE ARGUMENTS. ", n_line);
+        return;
+    }
+    if (block->pending != block->start) {
+        emit_error(program, "ELSE ALREADY USED IN THIS IF BLOCK. ", n_line);
+        return;
+    }
+    uint32_t jump = (uint32_t)program->count;
+    emit(program, OP_JUMP, n_line);
+    program->code[block->start].jump = jump + 1;
+    block->pending = jump;
+}
+
+// ENDO: chiude il blocco più interno risolvendo il salto rimasto in sospeso. Un ciclo
+// termina con OP_NEXT, che torna all'inizio: il corpo resta compilato e non viene riletto
+static void compile_endo(Program *program, LineCompiler *lc, int t, int n_line) {
+    OpenBlock *block = innermost_block(lc);
+    if (!block) {
+        emit_error(program, "ENDO WITHOUT MATCHING IF, WHILE OR REPEAT. ", n_line);
+        return;
+    }
+    if (t > 1) {
+        emit_error(program, "ENDO DOES NOT TAKE ARGUMENTS. ", n_line);
+        return;
+    }
+    if (block->kind != BLOCK_IF && program->code[block->start].op != OP_ERROR) {
+        // WHILE ricontrolla la condizione, REPEAT riparte dal corpo se il contatore non è esaurito
+        int slot = program->code[block->start].slot;
+        Instruction *in = emit(program, OP_NEXT, n_line);
+        in->slot = slot;
+        in->jump = block->kind == BLOCK_WHILE ? block->start : block->start + 1;
+    }
+    program->code[block->pending].jump = (uint32_t)program->count;
+    lc->block_count--;
+}
+
+// Fine dello script: un blocco senza ENDO diventa l'errore della sua riga
+void finish_source(LineCompiler *lc, Program *program) {
+    for (size_t i = 0; i < lc->block_count; i++) {
+        Instruction *in = &program->code[lc->blocks[i].start];
+        if (in->op == OP_ERROR) continue; // apertura già errata
+        char msg[64];
+        snprintf(msg, sizeof(msg), "MISSING ENDO FOR %s STATEMENT. ", block_names[lc->blocks[i].kind]);
+        in->op = OP_ERROR;
+        in->text = add_string(program, msg, strlen(msg));
+    }
+    lc->block_count = 0;
+}
+
+// -------------------------- ARRAY --------------------------
+
+// ARRAY INT|FLOAT nome dimensione [valore]: la dimensione è un'espressione senza spazi
+static void compile_array(Interpreter *interp, Program *program, char *line, const char *line_copy, char **tokens, int t, int n_line) {
+    if (t < 4) {
+        emit_error(program, "ARRAY REQUIRES TYPE, NAME AND SIZE. ", n_line);
+        return;
+    }
+
+    VarType type = get_type_from_string(tokens[1]);
+    if (type != TYPE_INT && type != TYPE_FLOAT) {
+        emit_error(program, "ARRAY TYPE MUST BE INT OR FLOAT. ", n_line);
+        return;
+    }
+    if (is_reserved_keyword(tokens[2])) {
+        emit_error(program, "VARIABLE NAME CAN NOT BE A RESERVED KEYWORDS. ", n_line);
+        return;
+    }
+
+    int slot = intern_variable(interp, tokens[2]);
+    uint32_t first, count;
+    if (!add_expression(interp, program, tokens[3], &first, &count, n_line)) return;
+
+    Instruction *in = emit(program, OP_ARRAY, n_line);
+    in->slot = slot;
+    in->type = type == TYPE_INT ? TYPE_ARRAY_INT : TYPE_ARRAY_FLOAT;
+    in->expr = first;
+    in->expr_len = count;
+
+    // Valore iniziale: diventa un FILL sulla stessa riga
+    if (t > 4) {
+        if (!add_expression(interp, program, skip_spaces(after_token(line, line_copy, tokens[3])), &first, &count, n_line)) return;
+        in = emit(program, OP_FILL, n_line);
+        in->slot = slot;
+        in->expr = first;
+        in->expr_len = count;
+    }
+}
+
+// FILL nome valore / MAP nome espressione
+static void compile_bulk(Interpreter *interp, Program *program, OpCode op, char *args, char **tokens, int t, int n_line) {
+    if (t < 3) {
+        emit_error(program, op == OP_FILL ? "FILL REQUIRES AN ARRAY AND A VALUE. " : "MAP REQUIRES AN ARRAY AND AN EXPRESSION. ", n_line);
+        return;
+    }
+
+    int slot = intern_variable(interp, tokens[1]);
+    uint32_t first, count;
+    if (!add_expression(interp, program, skip_spaces(args + strlen(tokens[1])), &first, &count, n_line)) return;
+
+    Instruction *in = emit(program, op, n_line);
+    in->slot = slot;
+    in->expr = first;
+    in->expr_len = count;
+}
+
+// SUM|MIN|MAX|MEAN nome [risultato] / DOT a b [risultato]: senza risultato il valore viene stampato come da CALC
+static void compile_reduce(Interpreter *interp, Program *program, OpCode op, char **tokens, int t, int n_line) {
+    int arrays = op == OP_DOT ? 2 : 1;
+    if (t < 1 + arrays || t > 2 + arrays) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), op == OP_DOT ? "%s REQUIRES TWO ARRAYS. " : "%s REQUIRES AN ARRAY. ", get_opcode_name(op));
+        emit_error(program, msg, n_line);
+        return;
+    }
+    if (t == 2 + arrays && is_reserved_keyword(tokens[1 + arrays])) {
+        emit_error(program, "VARIABLE NAME CAN NOT BE A RESERVED KEYWORDS. ", n_line);
+        return;
+    }
+
+    Instruction *in = emit(program, op, n_line);
+    in->slot = intern_variable(interp, tokens[1]);
+    if (op == OP_DOT) in->operand = intern_variable(interp, tokens[2]);
+    if (t == 2 + arrays) in->target = intern_variable(interp, tokens[1 + arrays]);
+}
+
+static void compile_step(Interpreter *interp, Program *program, OpCode op, char **tokens, int t, int n_line) {
+    if (t < 2) {
+        emit_error(program, op == OP_INCREMENT ? "INCREMENT REQUIRES A VARIABLE NAME." : "DECREMENT REQUIRES A VARIABLE NAME. ", n_line);
+        return;
+    }
+
+    emit(program, op, n_line)->slot = intern_variable(interp, tokens[1]);
+}
+
+// Compila una singola riga già ripulita dai commenti
+static void compile_line(Interpreter *interp, Program *program, LineCompiler *lc, char *line, int n_line) {
+    // ---------- TOKENIZZAZIONE DELLA RIGA ----------
+    // Copia e token crescono con la riga più lunga vista finora: nessun limite fisso
+    size_t len = strlen(line);
+    if (len + 1 > lc->copy_cap) {
+        char *copy = realloc(lc->copy, len + 1);
+        if (!copy) handle_error(NULL, "OUT OF MEMORY. ", n_line);
+        lc->copy = copy;
+        lc->copy_cap = len + 1;
+    }
+    memcpy(lc->copy, line, len + 1);
+    char *line_copy = lc->copy;
+
+    int t = 0;
+    char *saveptr; // strtok_r: la compilazione può girare su più thread
+    char *token = strtok_r(line_copy, " ", &saveptr);
+    while(token) {
+        if ((size_t)t == lc->token_cap) {
+            size_t cap = lc->token_cap ? lc->token_cap * 2 : 32;
+            char **tokens = realloc(lc->tokens, cap * sizeof(char *));
+            if (!tokens) handle_error(NULL, "OUT OF MEMORY. ", n_line);
+            lc->tokens = tokens;
+            lc->token_cap = cap;
+        }
+        lc->tokens[t] = token;
+        token = strtok_r(NULL, " ", &saveptr);
+        t++;
+    }
+    if (t == 0) return;
+    char **tokens = lc->tokens;
+
+    char *args = skip_spaces(after_token(line, line_copy, tokens[0]));
+
+    // ---------- GESTIONE COMANDI ----------
+    // Un solo hash perfetto sul primo token, poi uno switch denso sull'enum
+    switch (lookup_keyword(tokens[0], strlen(tokens[0]))) {
+        case KW_CLEAR:
+            emit(program, OP_CLEAR, n_line);
+            return;
+
+        case KW_EXIT: {
+            Instruction *in = emit(program, OP_EXIT, n_line);
+            size_t len = strlen(args);
+            if (len > 0) {
+                if (len >= 2 && args[0] == '"' && args[len - 1] == '"') {
+                    args[len - 1] = '\0';
+                    args++;
+                }
+                compile_template(interp, program, args, &in->tpl, &in->tpl_len);
+            } else
+                in->tpl = NO_TEXT; // nessun messaggio: saluto predefinito
+            return;
+        }
+
+        case KW_LINE:
+            compile_line_command(interp, program, args, n_line);
+            return;
+
+        case KW_CALC:
+            if (t < 2 || strlen(args) == 0) {
+                emit_error(program, "CALC REQUIRES AN EXPRESSION. ", n_line);
+                return;
+            }
+            compile_calc(interp, program, args, n_line);
+            return;
+
+        case KW_SET:
+            compile_set(interp, program, tokens, t, n_line);
+            return;
+
+        case KW_SAY: {
+            if (t < 2) break; // SAY senza argomenti è un comando sconosciuto
+            if (!split_segments(lc, line, args, &lc->text, false)) {
+                emit_error(program, "MISSING CLOSING QUOTE IN SAY COMMAND. ", n_line);
+                return;
+            }
+            Instruction *in = emit(program, OP_SAY, n_line);
+            compile_template(interp, program, lc->text.data, &in->tpl, &in->tpl_len);
+            return;
+        }
+
+        case KW_LISTEN:
+            compile_listen(interp, program, lc, line, t, n_line);
+            return;
+
+        case KW_INCREMENT:
+            compile_step(interp, program, OP_INCREMENT, tokens, t, n_line);
+            return;
+
+        case KW_DECREMENT:
+            compile_step(interp, program, OP_DECREMENT, tokens, t, n_line);
+            return;
+
+        case KW_ARRAY:
+            compile_array(interp, program, line, line_copy, tokens, t, n_line);
+            return;
+
+        case KW_FILL:
+            compile_bulk(interp, program, OP_FILL, args, tokens, t, n_line);
+            return;
+
+        case KW_MAP:
+            compile_bulk(interp, program, OP_MAP, args, tokens, t, n_line);
+            return;
+
+        case KW_SUM:
+            compile_reduce(interp, program, OP_SUM, tokens, t, n_line);
+            return;
+
+        case KW_MIN:
+            compile_reduce(interp, program, OP_MIN, tokens, t, n_line);
+            return;
+
+        case KW_MAX:
+            compile_reduce(interp, program, OP_MAX, tokens, t, n_line);
+            return;
+
+        case KW_MEAN:
+            compile_reduce(interp, program, OP_MEAN, tokens, t, n_line);
+            return;
+
+        case KW_DOT:
+            compile_reduce(interp, program, OP_DOT, tokens, t, n_line);
+            return;
+
+        case KW_IF:
+            compile_block(interp, program, lc, BLOCK_IF, line, line_copy, tokens, t, n_line);
+            return;
+
+        case KW_WHILE:
+            compile_block(interp, program, lc, BLOCK_WHILE, line, line_copy, tokens, t, n_line);
+            return;
+
+        case KW_REPEAT:
+            compile_block(interp, program, lc, BLOCK_REPEAT, line, line_copy, tokens, t, n_line);
+            return;
+
+        case KW_ELSE:
+            compile_else(program, lc, t, n_line);
+            return;
+
+        case KW_ENDO:
+            compile_endo(program, lc, t, n_line);
+            return;
+
+        default:
+            break;
+    }
+
+    char msg[256];
+    snprintf(msg, sizeof(msg), "UNKNOWN COMMAND: %.200s", line);
+    emit_error(program, msg, n_line);
+}
+
+/// ----------------- FRONT END -----------------
+// Stato iniziale del front end: nessun buffer e nessun commento aperto
+void init_line_compiler(LineCompiler *lc) {
+    memset(lc, 0, sizeof(*lc));
+}
+
+void free_line_compiler(LineCompiler *lc) {
+    free(lc->copy);
+    free(lc->tokens);
+    free(lc->text.data);
+    free_line_marks(&lc->marks);
+    free(lc->blocks);
+    memset(lc, 0, sizeof(*lc));
+}
+
+// Fine della condizione di IF, WHILE e REPEAT (subito dopo DO) se la riga da from apre un blocco,
+// altrimenti from: prima di quel punto '<' e '>' sono operatori di confronto, non commenti.
+// Senza DO l'intera riga è la condizione, così l'errore arriva da compile_block
+static size_t block_condition_end(const char *line, size_t from, size_t len) {
+    size_t at = from;
+    bool first = true;
+    while (at < len && line[at] != '\n') {
+        if (line[at] == ' ') {
+            at++;
+            continue;
+        }
+        size_t word = at;
+        while (at < len && line[at] != ' ' && line[at] != '\n') at++;
+        Keyword keyword = lookup_keyword(line + word, at - word);
+        if (first) {
+            if (keyword != KW_IF && keyword != KW_WHILE && keyword != KW_REPEAT) return from;
+            first = false;
+        } else if (keyword == KW_DO)
+            return at;
+    }
+    return first ? from : at;
+}
+
+// Compila la riga successiva dello script (modificabile, con o senza '\n' finale).
+// Un solo passaggio di scan_line trova newline, commenti, "--" e virgolette; il resto
+// lavora sulla lista delle posizioni. Lo stato dei commenti multilinea resta in lc
+void compile_source_line(Interpreter *interp, LineCompiler *lc, Program *program, char *line, size_t len) {
+    int n_line = ++lc->n_line; // Numero corrente della riga
+    LineMarks *marks = &lc->marks;
+    scan_line(line, len, marks);
+
+    // ----------- NEWLINE E COMMENTI MULTILINEA ----------
+    // Dentro un commento aperto la riga riparte dopo il primo '>'; poi contano il primo '<'
+    // e il primo '>' rimasti dopo l'eventuale condizione di un blocco
+    size_t start = 0, end = len, open = SIZE_MAX, close = SIZE_MAX, condition = SIZE_MAX;
+    bool in_comment = lc->in_multiline_comment;
+    if (!in_comment) condition = block_condition_end(line, 0, len);
+    for (size_t i = 0; i < marks->count; i++) {
+        size_t at = marks->pos[i];
+        char c = line[at];
+        if (c == '\n') {
+            end = at; // Rimuove newline finale
+            break;
+        }
+        if (in_comment) {
+            if (c == '>') { // Fine del commento multilinea
+                in_comment = false;
+                start = at + 1;
+                condition = block_condition_end(line, start, len);
+            }
+        } else if (at < condition) continue;
+        else if (c == '<' && open == SIZE_MAX) open = at;
+        else if (c == '>' && close == SIZE_MAX) close = at;
+    }
+    if (in_comment) return; // Ignora tutta la riga
+    lc->in_multiline_comment = false;
+
+    // Testo che resta: [start, head_end) seguito da [tail_start, end)
+    size_t head_end = end, tail_start = end;
+    if (open != SIZE_MAX && close != SIZE_MAX && open < close) {
+        // Commento chiuso nella stessa riga
+        head_end = open;
+        tail_start = close + 1;
+    } else if (open != SIZE_MAX && close == SIZE_MAX) {
+        // Inizio di un commento multilinea: tronca a inizio commento
+        lc->in_multiline_comment = true;
+        head_end = open;
+    }
+
+    // ---------- GESTIONE COMMENTI DI LINEA ----------
+    // Il primo "--" del testo rimasto, anche a cavallo del commento tolto
+    for (size_t i = 0; i < marks->count; i++) {
+        size_t at = marks->pos[i];
+        if (at >= end) break;
+        if (line[at] != '-') continue;
+        if (at >= start && at < head_end) {
+            char next = at + 1 < head_end ? line[at + 1] : tail_start < end ? line[tail_start] : '\0';
+            if (next == '-') {
+                head_end = at;
+                tail_start = end = at;
+                break;
+            }
+        } else if (at >= tail_start && at + 1 < end && line[at + 1] == '-') {
+            end = at;
+            break;
+        }
+    }
+
+    size_t head_len = head_end - start, tail_len = end > tail_start ? end - tail_start : 0;
+    if (head_len + tail_len == 0) return; // Salta righe vuote
+
+    // Le virgolette rimaste, rinumerate sulla riga ricomposta, servono a SAY e LISTEN
+    size_t quotes = 0;
+    for (size_t i = 0; i < marks->count; i++) {
+        size_t at = marks->pos[i];
+        if (at >= end) break;
+        if (line[at] != '"') continue;
+        if (at >= start && at < head_end) marks->pos[quotes++] = (uint32_t)(at - start);
+        else if (at >= tail_start) marks->pos[quotes++] = (uint32_t)(head_len + at - tail_start);
+    }
+    marks->count = quotes;
+
+    // Ricompone la riga: un solo memmove se c'era un commento in mezzo
+    if (tail_len && tail_start != head_end) memmove(line + head_end, line + tail_start, tail_len);
+    line[head_end + tail_len] = '\0';
+
+    compile_line(interp, program, lc, line + start, n_line);
+}
+
+// Legge l'intero script e lo traduce in un array piatto di istruzioni
+void compile_file(Interpreter *interp, FILE *file, Program *program) {
+    LineCompiler lc;
+    init_line_compiler(&lc);
+    char *line = NULL; // Buffer della riga, cresce con getline
+    size_t line_cap = 0;
+
+    ssize_t len;
+    while ((len = getline(&line, &line_cap, file)) >= 0) // Legge una riga per volta
+        compile_source_line(interp, &lc, program, line, (size_t)len);
+    finish_source(&lc, program);
+
+    free(line);
+    free_line_compiler(&lc);
+}
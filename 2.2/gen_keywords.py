@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+# Genera keywords-2.2.h e keywords-2.2.c: tabella hash perfetta (case-insensitive)
+# di tutte le parole chiave del linguaggio.
+#
+# Uso: python3 gen_keywords.py   (da eseguire nella cartella 2.2)
+
+import itertools
+import sys
+
+# (parola chiave, riservata come nome di variabile)
+KEYWORDS = [
+    ("INT", True), ("FLOAT", True), ("CHAR", True), ("STR", True), ("BOOL", True),
+    ("SET", True), ("CONST", True), ("SAY", True), ("LISTEN", True), ("EXIT", True),
+    ("LINE", True), ("CLEAR", True), ("CALC", True),
+    ("INCREMENT", False), ("DECREMENT", False),
+    ("ARRAY", True), ("FILL", False), ("MAP", False),
+    ("SUM", False), ("MIN", False), ("MAX", False), ("MEAN", False), ("DOT", False),
+    ("IF", True), ("DO", False), ("ELSE", True), ("ENDO", True), ("WHILE", True), ("REPEAT", True),
+    ("AND", False), ("OR", False), ("XOR", False), ("NOT", False),
+    ("TRUE", False), ("FALSE", False),
+]
+
+TABLE_SIZE = 128
+
+
+def kw_hash(word, a, b, c):
+    w = word.upper()
+    return (ord(w[0]) * a + ord(w[-1]) * b + ord(w[len(w) // 2]) + len(w) * c) & (TABLE_SIZE - 1)
+
+
+def find_parameters():
+    for a, b, c in itertools.product(range(1, 32), repeat=3):
+        seen = set()
+        for word, _ in KEYWORDS:
+            h = kw_hash(word, a, b, c)
+            if h in seen:
+                break
+            seen.add(h)
+        else:
+            return a, b, c
+    sys.exit("nessuna funzione hash perfetta trovata: aumentare TABLE_SIZE")
+
+
+def main():
+    a, b, c = find_parameters()
+    min_len = min(len(w) for w, _ in KEYWORDS)
+    max_len = max(len(w) for w, _ in KEYWORDS)
+
+    slots = ["    {NULL, 0, KW_NONE},"] * TABLE_SIZE
+    for word, _ in KEYWORDS:
+        slots[kw_hash(word, a, b, c)] = '    {"%s", %d, KW_%s},' % (word, len(word), word)
+
+    header = """// GENERATO DA gen_keywords.py - NON MODIFICARE A MANO
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// Parole chiave del linguaggio (comandi, tipi, operatori logici, booleani)
+typedef enum {
+    KW_NONE,
+%s
+    KW_COUNT
+} Keyword;
+
+// Dichiarazione delle funzioni di ricerca
+Keyword lookup_keyword(const char *word, size_t len);
+bool is_reserved(Keyword kw);
+
+#endif
+""" % "\n".join("    KW_%s," % w for w, _ in KEYWORDS)
+
+    source = """// GENERATO DA gen_keywords.py - NON MODIFICARE A MANO
+#include <ctype.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "keywords-2.2.h"
+
+#define KW_TABLE_SIZE %d
+#define KW_MIN_LENGTH %d
+#define KW_MAX_LENGTH %d
+
+// Voce della tabella: parola in maiuscolo, lunghezza ed enum
+typedef struct {
+    const char *word;
+    size_t len;
+    Keyword kw;
+} KeywordEntry;
+
+static const KeywordEntry keyword_table[KW_TABLE_SIZE] = {
+%s
+};
+
+// Funzione hash perfetta: nessuna collisione tra le parole chiave
+static unsigned keyword_hash(const char *word, size_t len) {
+    unsigned first = (unsigned)toupper((unsigned char)word[0]);
+    unsigned last = (unsigned)toupper((unsigned char)word[len - 1]);
+    unsigned middle = (unsigned)toupper((unsigned char)word[len / 2]);
+    return (first * %du + last * %du + middle + (unsigned)len * %du) & (KW_TABLE_SIZE - 1);
+}
+
+// Restituisce la parola chiave corrispondente (senza distinzione maiuscole/minuscole) o KW_NONE
+Keyword lookup_keyword(const char *word, size_t len) {
+    if (len < KW_MIN_LENGTH || len > KW_MAX_LENGTH) return KW_NONE;
+
+    const KeywordEntry *entry = &keyword_table[keyword_hash(word, len)];
+    if (entry->len != len) return KW_NONE;
+    for (size_t i = 0; i < len; i++) {
+        if (toupper((unsigned char)word[i]) != entry->word[i]) return KW_NONE;
+    }
+    return entry->kw;
+}
+
+// Parole chiave che non possono essere usate come nome di variabile
+static const bool reserved_table[KW_COUNT] = {
+%s
+};
+
+bool is_reserved(Keyword kw) {
+    return reserved_table[kw];
+}
+""" % (TABLE_SIZE, min_len, max_len, "\n".join(slots), a, b, c,
+       "\n".join("    [KW_%s] = true," % w for w, r in KEYWORDS if r))
+
+    with open("keywords-2.2.h", "w") as f:
+        f.write(header)
+    with open("keywords-2.2.c", "w") as f:
+        f.write(source)
+
+
+if __name__ == "__main__":
+    main()
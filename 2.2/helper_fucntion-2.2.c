@@ -3,15 +3,59 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include <inttypes.h>
+#include <unistd.h>
 
 #include "helper_function-2.2.h"
+#include "keywords-2.2.h"
+#include "output-2.2.h"
+#include "array-2.2.h"
+#include "string-2.2.h"
+#include "input-2.2.h"
+#include "number-2.2.h"
 
 // -------------------------- IMPLEMENTAZIONE FUNZIONI DI SUPPORTO --------------------------
 
-// Gestisce errori, stampa il messaggio di errore e termina il programma
-void handle_error(const char *message, int line_number) {
-    fprintf(stderr, "LINE %d -> ERROR: %s\n", line_number, message);
-    exit(EXIT_FAILURE); // termina il programma zon stato di errore
+// Gestisce errori: stampa (o cattura) il messaggio e torna al chiamante dell'interprete.
+// Senza interprete, o fuori da un'esecuzione, termina il programma come prima.
+void handle_error(Interpreter *interp, const char *message, int line_number) {
+    if (!interp) {
+        fprintf(stderr, "LINE %d -> ERROR: %s\n", line_number, message);
+        exit(EXIT_FAILURE);
+    }
+
+    output_flush(interp); // l'output già prodotto precede sempre il messaggio di errore
+    if (interp->error_fd < 0) {
+        char text[512];
+        int len = snprintf(text, sizeof(text), "LINE %d -> ERROR: %s\n", line_number, message);
+        if (len >= (int)sizeof(text)) len = sizeof(text) - 1;
+        text_append(&interp->errors, text, len);
+    } else
+        fprintf(stderr, "LINE %d -> ERROR: %s\n", line_number, message);
+
+    interp->exit_code = EXIT_FAILURE;
+    if (!interp->on_error) exit(EXIT_FAILURE); // termina il programma zon stato di errore
+    longjmp(*interp->on_error, 1);
+}
+
+// Garantisce spazio per altri extra byte (più il terminatore)
+void text_reserve(TextBuffer *buffer, size_t extra) {
+    if (buffer->len + extra + 1 <= buffer->cap) return;
+
+    size_t cap = buffer->cap ? buffer->cap : 256;
+    while (buffer->len + extra + 1 > cap) cap *= 2;
+    char *data = realloc(buffer->data, cap);
+    if (!data) handle_error(NULL, "OUT OF MEMORY. ", -1);
+    buffer->data = data;
+    buffer->cap = cap;
+}
+
+// Accoda len byte al buffer, facendolo crescere se serve
+void text_append(TextBuffer *buffer, const char *src, size_t len) {
+    text_reserve(buffer, len);
+    memcpy(buffer->data + buffer->len, src, len);
+    buffer->len += len;
+    buffer->data[buffer->len] = '\0';
 }
 
 // Converte un tipo (VarType) in stringa rappresentativa
@@ -22,78 +66,199 @@ const char *get_string_from_type(VarType type) {
         case TYPE_CHAR: return "CHAR";
         case TYPE_STR: return "STR";
         case TYPE_BOOL: return "BOOL";
+        case TYPE_ARRAY_INT: return "ARRAY INT";
+        case TYPE_ARRAY_FLOAT: return "ARRAY FLOAT";
         default: return "UNKNOW";
     }
 }
 
 // Converte una stringa in un tipo (VarType) corrispondente
 VarType get_type_from_string(const char *type_str) {
-    if (strcasecmp(type_str, "INT") == 0) return TYPE_INT;
-    if (strcasecmp(type_str, "FLOAT") == 0) return TYPE_FLOAT;
-    if (strcasecmp(type_str, "CHAR") == 0) return TYPE_CHAR;
-    if (strcasecmp(type_str, "STR") == 0) return TYPE_STR;
-    if (strcasecmp(type_str, "BOOL") == 0) return TYPE_BOOL;
-    return TYPE_UNKNOW;
-}
-
-// Cerca una variabile per nome
-Variable *find_variable(const char *name) {
-    for(int i = 0; i < n; i++) {
-        if (strcmp(stack[i].name, name) == 0)
-            return &stack[i];
+    switch (lookup_keyword(type_str, strlen(type_str))) {
+        case KW_INT: return TYPE_INT;
+        case KW_FLOAT: return TYPE_FLOAT;
+        case KW_CHAR: return TYPE_CHAR;
+        case KW_STR: return TYPE_STR;
+        case KW_BOOL: return TYPE_BOOL;
+        default: return TYPE_UNKNOW;
     }
-    return NULL;
 }
 
-// Funzione per verificare se un nome è una parola riservata
-bool is_reserved_keyword(const char *name){
-    for (int i = 0; i < num_reversed_keywords; i++) {
-        if(strcasecmp(name, reserved_keywords[i]) == 0) return true;
+// -------------------------- CONTESTO DELL'INTERPRETE --------------------------
+
+// Contesto vuoto: output su stdout, errori su stderr, input da stdin
+void init_interpreter(Interpreter *interp) {
+    memset(interp, 0, sizeof(*interp));
+    interp->output_fd = STDOUT_FILENO;
+    interp->error_fd = STDERR_FILENO;
+    input_from_fd(&interp->input, STDIN_FILENO, false);
+}
+
+// Libera variabili, tabella dei simboli e buffer
+void free_interpreter(Interpreter *interp) {
+    for (int i = 0; i < interp->n; i++) {
+        const Variable *var = &interp->stack[i];
+        if (!var->is_declared) continue;
+        if (var->type == TYPE_ARRAY_INT || var->type == TYPE_ARRAY_FLOAT) free_array(var->value.a_val);
     }
-    return false;
+    free(interp->stack);
+    free(interp->symbol_index);
+    free(interp->output.data);
+    free(interp->errors.data);
+    free(interp->message.data);
+    free(interp->scratch);
+    free_string_arena(interp);
+    free_input(&interp->input);
+    memset(interp, 0, sizeof(*interp));
 }
 
-// Crea una nuova variabile e la aggiunge alla stack
-void create_variable(const char *name, VarType type, const char *value_str, bool is_const, int line_number) {
-    if (n >= MAX_VARS) handle_error("MAXIMUM NUMBER OF VARIABLES REACHED. ", line_number);
-    if (find_variable(name)) handle_error("VARIABLE ALREADY DECLARED. ", line_number);
-    if (is_reserved_keyword(name)) handle_error("VARIABLE NAME CAN NOT BE A RESERVED KEYWORDS. ", line_number);
+// -------------------------- TABELLA DEI SIMBOLI --------------------------
+// Indice hash a indirizzamento aperto sopra la stack: ogni cella contiene slot + 1 (0 = vuota).
+// I nomi oltre MAX_VAR_NAME - 1 caratteri vengono troncati.
 
-    Variable v;
+// Hash FNV-1a del nome
+static uint32_t hash_name(const char *name, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)name[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Cerca lo slot associato al nome, -1 se non è mai stato internato
+static int lookup_slot(const Interpreter *interp, const char *name, size_t len, uint32_t hash) {
+    if (interp->index_capacity == 0) return -1;
+
+    size_t mask = interp->index_capacity - 1;
+    for (size_t i = hash & mask; interp->symbol_index[i]; i = (i + 1) & mask) {
+        Variable *v = &interp->stack[interp->symbol_index[i] - 1];
+        if (v->hash == hash && strncmp(v->name, name, len) == 0 && v->name[len] == '\0')
+            return interp->symbol_index[i] - 1;
+    }
+    return -1;
+}
+
+// Inserisce uno slot nell'indice (la cella libera esiste sempre: fattore di carico <= 1/2)
+static void index_insert(Interpreter *interp, int slot) {
+    size_t mask = interp->index_capacity - 1;
+    size_t i = interp->stack[slot].hash & mask;
+    while (interp->symbol_index[i]) i = (i + 1) & mask;
+    interp->symbol_index[i] = slot + 1;
+}
+
+// Raddoppia l'indice e reinserisce tutti gli slot
+static void grow_index(Interpreter *interp) {
+    size_t capacity = interp->index_capacity ? interp->index_capacity * 2 : 128;
+    int *index = calloc(capacity, sizeof(int));
+    if (!index) handle_error(NULL, "OUT OF MEMORY. ", -1);
+
+    free(interp->symbol_index);
+    interp->symbol_index = index;
+    interp->index_capacity = capacity;
+    for (int i = 0; i < interp->n; i++) index_insert(interp, i);
+}
+
+// Restituisce lo slot di una variabile, creandone uno vuoto se il nome è nuovo
+int intern_variable(Interpreter *interp, const char *name) {
+    return intern_variable_len(interp, name, strlen(name));
+}
 
-    v.type = type;
-    v.is_const = is_const;
-    strncpy(v.name, name, MAX_VAR_NAME);
+// Come intern_variable, ma il nome è uno span non terminato da '\0'
+int intern_variable_len(Interpreter *interp, const char *name, size_t len) {
+    if (len > MAX_VAR_NAME - 1) len = MAX_VAR_NAME - 1;
+    uint32_t hash = hash_name(name, len);
 
+    int slot = lookup_slot(interp, name, len, hash);
+    if (slot >= 0) return slot;
+
+    if (interp->n == interp->stack_capacity) {
+        int capacity = interp->stack_capacity ? interp->stack_capacity * 2 : 64;
+        Variable *grown = realloc(interp->stack, capacity * sizeof(Variable));
+        if (!grown) handle_error(NULL, "OUT OF MEMORY. ", -1);
+        interp->stack = grown;
+        interp->stack_capacity = capacity;
+    }
+    if ((size_t)(interp->n + 1) * 2 > interp->index_capacity) grow_index(interp);
+
+    Variable *v = &interp->stack[interp->n];
+    memset(v, 0, sizeof(*v));
+    memcpy(v->name, name, len);
+    v->hash = hash;
+    v->type = TYPE_UNKNOW;
+    index_insert(interp, interp->n);
+    return interp->n++;
+}
+
+// Cerca una variabile dichiarata per nome
+Variable *find_variable(Interpreter *interp, const char *name) {
+    return find_variable_len(interp, name, strlen(name));
+}
+
+// Come find_variable, ma il nome è uno span non terminato da '\0'
+Variable *find_variable_len(Interpreter *interp, const char *name, size_t len) {
+    if (len > MAX_VAR_NAME - 1) len = MAX_VAR_NAME - 1;
+    int slot = lookup_slot(interp, name, len, hash_name(name, len));
+    if (slot < 0 || !interp->stack[slot].is_declared) return NULL;
+    return &interp->stack[slot];
+}
+
+// Funzione per verificare se un nome è una parola riservata
+bool is_reserved_keyword(const char *name){
+    return is_reserved(lookup_keyword(name, strlen(name)));
+}
+
+// Converte un valore testuale in un tipo scalare (NULL oppure il messaggio d'errore).
+// Le STR passano da string_assign, che ha bisogno dell'arena dell'interprete
+const char *parse_value(const char *value_str, VarType type, Value *out) {
     switch (type) {
         case TYPE_INT:
-            v.value.i_val = value_str ? atoi(value_str) : 0;
-            break;
+            if (!value_str) {
+                out->i_val = 0;
+                return NULL;
+            }
+            switch (parse_int(value_str, strlen(value_str), &out->i_val)) {
+                case NUMBER_OK: return NULL;
+                case NUMBER_RANGE: return "INTEGER VALUE OUT OF RANGE. ";
+                default: return "INVALID VALUE FOR INT VARIABLE. ";
+            }
         case TYPE_FLOAT:
-            v.value.f_val = value_str ? atof(value_str) : 0.0f;
-            break;
+            if (!value_str) {
+                out->f_val = 0.0;
+                return NULL;
+            }
+            switch (parse_float(value_str, strlen(value_str), &out->f_val)) {
+                case NUMBER_OK: return NULL;
+                case NUMBER_RANGE: return "FLOAT VALUE OUT OF RANGE. ";
+                default: return "INVALID VALUE FOR FLOAT VARIABLE. ";
+            }
         case TYPE_CHAR:
-            v.value.c_val = value_str ? value_str[0] : '\0';
-            break;
-        case TYPE_STR:  
-            v.value.s_val = value_str ? strdup(value_str) : strdup("");
-            break;
+            out->c_val = value_str ? value_str[0] : '\0';
+            return NULL;
         case TYPE_BOOL:
-            if (value_str) {
-                if (strcmp(value_str, "true") == 0) {
-                    v.value.b_val = true;
-                } else if (strcmp(value_str, "false") == 0) {
-                    v.value.b_val = false;
-                } else 
-                    handle_error("INVALID VALUE FOR BOOL VARIABLE. ONLY true OR false ARE ALLOWED. ", line_number);
-            } else 
-                v.value.b_val = false;
-            break;
-        default: handle_error("UNSUPPORTED TYPE IN SET. ", line_number);            
+            if (!value_str || strcmp(value_str, "false") == 0) {
+                out->b_val = false;
+                return NULL;
+            }
+            if (strcmp(value_str, "true") == 0) {
+                out->b_val = true;
+                return NULL;
+            }
+            return "INVALID VALUE FOR BOOL VARIABLE. ONLY true OR false ARE ALLOWED. ";
+        default: return "UNKNOWN TYPE IN SET. ";
     }
+}
+
+// Dichiara la variabile nello slot indicato; il valore viene assegnato dal chiamante
+Variable *declare_variable(Interpreter *interp, int slot, VarType type, bool is_const, int line_number) {
+    Variable *v = &interp->stack[slot];
+    if (v->is_declared) handle_error(interp, "VARIABLE ALREADY DECLARED. ", line_number);
+    if (type == TYPE_UNKNOW) handle_error(interp, "UNSUPPORTED TYPE IN SET. ", line_number);
 
-    stack[n] = v;
-    n++;
+    v->type = type;
+    v->is_const = is_const;
+    v->is_declared = true;
+    return v;
 }
 
 // Gestisce caratteri speciali in stringhe
@@ -126,7 +291,7 @@ void escape_special_chars(const char *src, char *dest, size_t max_len) {
 }
 
 // Espande variabili e semiboli speciali
-void expand_variables(const char *input, char *output, size_t max_len) {
+void expand_variables(Interpreter *interp, const char *input, char *output, size_t max_len) {
     char temp_out[2048] = {0};
     const char *p = input;
     size_t j = 0;
@@ -142,15 +307,42 @@ void expand_variables(const char *input, char *output, size_t max_len) {
             }
             var_name[i] = '\0';
 
-            Variable *var = find_variable(var_name);
-            if (var) {
+            Variable *var = find_variable(interp, var_name);
+            if (var && is_array_type(var->type) && symbol == '@') {
+                // @arr[i] con indice numerico o variabile INT, @arr per l'intero array
+                int64_t index = -1; // -1 = intero array
+                const char *close = *p == '[' ? strchr(p, ']') : NULL;
+                if (close) {
+                    char index_name[MAX_VAR_NAME] = {0};
+                    size_t len = (size_t)(close - p - 1) < MAX_VAR_NAME - 1 ? (size_t)(close - p - 1) : MAX_VAR_NAME - 1;
+                    memcpy(index_name, p + 1, len);
+                    if (isdigit((unsigned char)index_name[0])) {
+                        if (parse_int(index_name, len, &index) != NUMBER_OK) index = -1;
+                    } else {
+                        const Variable *position = find_variable(interp, index_name);
+                        index = position && position->type == TYPE_INT ? position->value.i_val : -1;
+                    }
+                    if (index < 0) index = (int64_t)var->value.a_val->len; // fuori intervallo: [undefined]
+                    p = close + 1;
+                }
+                TextBuffer text = {0};
+                append_array(&text, var->value.a_val, index);
+                if (text.data) strncat(temp_out, text.data, max_len - strlen(temp_out) - 1);
+                free(text.data);
+                j = strlen(temp_out);
+            } else if (var) {
                 char temp[256];
                 if (symbol == '@') {
                     switch (var->type) {
-                        case TYPE_INT: snprintf(temp, sizeof(temp), "%d", var->value.i_val); break;
-                        case TYPE_FLOAT: snprintf(temp, sizeof(temp), "%.2f", var->value.f_val); break;
+                        case TYPE_INT: temp[format_int(temp, var->value.i_val)] = '\0'; break;
+                        case TYPE_FLOAT: {
+                            size_t len = format_fixed(temp, var->value.f_val, 2);
+                            if (len) temp[len] = '\0';
+                            else snprintf(temp, sizeof(temp), "%.2f", var->value.f_val);
+                            break;
+                        }
                         case TYPE_CHAR: snprintf(temp, sizeof(temp), "%c", var->value.c_val); break;
-                        case TYPE_STR: snprintf(temp, sizeof(temp), "%s", var->value.s_val); break;
+                        case TYPE_STR: snprintf(temp, sizeof(temp), "%.*s", (int)var->value.s_val.len, string_data(&var->value.s_val)); break;
                         case TYPE_BOOL: snprintf(temp, sizeof(temp), "%s", var->value.b_val ? "true" : "false"); break;
                         default: snprintf(temp, sizeof(temp), "[unknown]"); break;
                     }
@@ -177,27 +369,13 @@ bool is_valid_input(const char *input, VarType type) {
 
     switch (type) {
         case TYPE_INT: {
-            size_t i = 0;
-            if (input[i] == '-') i++; // accetta numeri negativi
-            if(i >= strlen(input)) return false; // solo un -
-            for(; input[i]; i++)
-                if (!isdigit(input[i])) return false;
-            return false;
+            int64_t value;
+            return parse_int(input, strlen(input), &value) == NUMBER_OK;
         }
 
         case TYPE_FLOAT: {
-            bool dot_found = false;
-            size_t i = 0;
-            if (input[i] == '-') i++;
-            if (i >= strlen(input)) return false;
-            for (; input[i]; i++) {
-                if (input[i] == '.') {
-                    if (dot_found) return false;
-                    dot_found = true;
-                } else if (!isdigit(input[i])) return false;
-            }
-
-            return true;
+            double value;
+            return parse_float(input, strlen(input), &value) == NUMBER_OK;
         }
 
         case TYPE_CHAR:
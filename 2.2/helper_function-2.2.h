@@ -5,46 +5,123 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <stdbool.h>
+#include <setjmp.h>
 
 // Definizione condivise con il main
 #define MAX_VAR_NAME 64
-#define MAX_VARS 128
 
 // Dichirazione dei tipi
 typedef enum {
-    TYPE_INT, TYPE_FLOAT, TYPE_CHAR, TYPE_STR, TYPE_BOOL, TYPE_UNKNOW
+    TYPE_INT, TYPE_FLOAT, TYPE_CHAR, TYPE_STR, TYPE_BOOL, TYPE_ARRAY_INT, TYPE_ARRAY_FLOAT, TYPE_UNKNOW
 } VarType;
 
+struct Array;
+struct StringChunk;
+
+// Testi fino a questa lunghezza stanno dentro la variabile, senza allocazioni
+#define STRING_INLINE_CAPACITY 15
+
+// Stringa con lunghezza esplicita, sempre terminata da '\0'.
+// Tutta a zero è la stringa vuota; i testi lunghi vivono nell'arena dell'interprete
+typedef struct String {
+    uint32_t len;
+    uint32_t cap;   // capacità del buffer nell'arena ('\0' compreso), 0 = testo inline
+    union {
+        char *ptr;
+        char inline_text[STRING_INLINE_CAPACITY + 1];
+    } data;
+} String;
+
+// Valore di una variabile (condiviso con i letterali compilati)
+typedef union Value {
+    int64_t i_val;
+    double f_val;
+    char c_val;
+    String s_val;
+    bool b_val;
+    struct Array *a_val; // TYPE_ARRAY_INT, TYPE_ARRAY_FLOAT
+} Value;
+
 // Dichiarazione della struttura
 typedef struct Variable {
     char name[MAX_VAR_NAME];
+    uint32_t hash; // calcolato una sola volta quando il nome viene internato
     VarType type;
-    union {
-        int i_val;
-        float f_val;
-        char c_val;
-        char *s_val;
-        bool b_val;
-    } value;
+    Value value;
     bool is_const;
+    bool is_declared; // false finché SET/LISTEN non la dichiara a runtime
 } Variable;
 
-// DIchiarazione delle variabili globali defnite nel main
-extern int n;
-extern Variable stack[MAX_VARS];
-extern const char *reserved_keywords[];
-extern const int num_reversed_keywords;
+// Buffer di testo crescente, sempre terminato da '\0'
+typedef struct TextBuffer {
+    char *data;
+    size_t len;
+    size_t cap;
+} TextBuffer;
+
+// Sorgente delle righe lette da LISTEN: file mappato, pipe o terminale letti a blocchi,
+// oppure testo in memoria. Le righe vengono restituite come span, senza copie
+typedef struct InputSource {
+    int fd;              // descrittore da leggere, -1 = nessuno
+    bool owns_fd;        // chiuso da free_input (--input)
+    bool ready;          // false finché la prima lettura non sceglie tra mmap e blocchi
+    bool interactive;    // terminale: il prompt va mostrato prima di leggere
+    bool eof;
+    const char *data;    // testo disponibile: le righe non consumate sono data[pos..len)
+    size_t pos;
+    size_t len;
+    char *buffer;        // blocchi letti da pipe e terminali
+    size_t cap;
+    void *map;           // file regolare mappato per intero
+    size_t map_size;
+    FILE *record;        // se presente ogni riga letta viene registrata qui (--record)
+} InputSource;
+
+// Contesto di un interprete: tutto lo stato di uno script, così più script possono
+// girare nello stesso processo (anche su thread diversi) senza interferire
+typedef struct Interpreter {
+    Variable *stack;        // Variabili, indicizzate per slot
+    int n;                  // Numero di slot assegnati
+    int stack_capacity;
+    int *symbol_index;      // Indice hash dei nomi: slot + 1 (0 = cella vuota)
+    size_t index_capacity;  // sempre potenza di due
+    TextBuffer output;      // Output bufferizzato
+    TextBuffer errors;      // Messaggi d'errore catturati (se error_fd < 0)
+    TextBuffer message;     // Buffer di lavoro della VM
+    int output_fd;          // Destinazione dell'output, -1 = resta nel buffer
+    void (*sink)(void *user_data, const char *data, size_t len); // Se presente sostituisce output_fd
+    void *sink_data;
+    int error_fd;           // -1 = errori catturati in errors invece che su stderr
+    InputSource input;      // Sorgente di LISTEN (fd -1 = nessun input)
+    jmp_buf *on_error;      // Punto di ripresa dopo un errore (NULL = termina il processo)
+    int exit_code;
+    void *scratch;          // Buffer di lavoro allineato delle operazioni sugli array
+    size_t scratch_size;
+    struct StringChunk *strings; // Arena delle stringhe lunghe, liberata in blocco alla fine
+    bool quiet_prompts;     // LISTEN non stampa il prompt (--quiet-prompts)
+    bool use_cache;         // Riusa/scrive l'immagine compilata .nobc accanto allo script
+    bool use_jit;           // Traduce in codice nativo le espressioni calde (--jit)
+} Interpreter;
 
 // Dichiarazione delle funzioni di supporto
-Variable *find_variable(const char *name);
+void init_interpreter(Interpreter *interp);
+void free_interpreter(Interpreter *interp);
+int intern_variable(Interpreter *interp, const char *name);
+int intern_variable_len(Interpreter *interp, const char *name, size_t len);
+Variable *find_variable(Interpreter *interp, const char *name);
+Variable *find_variable_len(Interpreter *interp, const char *name, size_t len);
 bool is_reserved_keyword(const char *name);
 const char *get_string_from_type(VarType type);
 VarType get_type_from_string(const char *type_str);
 bool is_valid_input(const char *input, VarType type);
-void handle_error(const char *message, int line_number);
+const char *parse_value(const char *value_str, VarType type, Value *out);
+void handle_error(Interpreter *interp, const char *message, int line_number);
+void text_reserve(TextBuffer *buffer, size_t extra);
+void text_append(TextBuffer *buffer, const char *src, size_t len);
 void escape_special_chars(const char *src, char *dest, size_t max_len);
-void expand_variables(const char *input, char *output, size_t max_len);
-void create_variables(const char *name, VarType type, const char *value_str, bool is_const, int line_number);
+void expand_variables(Interpreter *interp, const char *input, char *output, size_t max_len);
+Variable *declare_variable(Interpreter *interp, int slot, VarType type, bool is_const, int line_number);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,154 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "input-2.2.h"
+
+// Le righe per LISTEN arrivano da un'unica sorgente per contesto. Un file regolare (anche
+// stdin rediretto da file) viene mappato e le righe sono span dentro la mappatura; pipe e
+// terminali vengono letti a blocchi grandi in un buffer che si ricompatta quando serve.
+// Uno span resta valido fino alla lettura successiva.
+
+// Sorgente sul descrittore indicato; -1 = nessun input. Non fa chiamate di sistema:
+// la scelta tra mmap e blocchi avviene alla prima lettura
+void input_from_fd(InputSource *input, int fd, bool owns_fd) {
+    FILE *record = input->record; // la registrazione sopravvive al cambio di sorgente
+    input->record = NULL;
+    free_input(input);
+    input->fd = fd;
+    input->owns_fd = owns_fd && fd >= 0;
+    input->record = record;
+}
+
+// Sorgente su un testo del chiamante, che deve restare valido finché viene letto
+void input_from_memory(InputSource *input, const char *data, size_t len) {
+    input_from_fd(input, -1, false);
+    input->ready = true;
+    input->eof = true;
+    input->data = data;
+    input->len = data ? len : 0;
+}
+
+// Apre un file di risposte (--input)
+bool input_open_file(InputSource *input, const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    input_from_fd(input, fd, true);
+    return true;
+}
+
+// Registra su path ogni riga letta: il file si può rigiocare con --input
+bool input_record(InputSource *input, const char *path) {
+    FILE *record = fopen(path, "w");
+    if (!record) return false;
+    if (input->record) fclose(input->record);
+    input->record = record;
+    return true;
+}
+
+// Prima lettura: mappa i file regolari, altrimenti prepara la lettura a blocchi
+static void input_prepare(InputSource *input) {
+    input->ready = true;
+    if (input->fd < 0) {
+        input->eof = true;
+        return;
+    }
+
+    struct stat info;
+    if (fstat(input->fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        off_t offset = lseek(input->fd, 0, SEEK_CUR); // stdin può essere già stato letto in parte
+        void *map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, input->fd, 0);
+        if (map != MAP_FAILED) {
+            input->map = map;
+            input->map_size = (size_t)info.st_size;
+            input->data = map;
+            input->len = input->map_size;
+            input->pos = offset > 0 && (size_t)offset < input->len ? (size_t)offset : 0;
+            input->eof = true;
+            return;
+        }
+    }
+    input->interactive = isatty(input->fd);
+}
+
+// true se la sorgente è un terminale (il prompt deve essere visibile prima di leggere)
+bool input_is_interactive(InputSource *input) {
+    if (!input->ready) input_prepare(input);
+    return input->interactive;
+}
+
+// Legge il blocco successivo in coda alla riga incompleta, che torna all'inizio del buffer
+static void input_fill(InputSource *input) {
+    size_t rest = input->len - input->pos;
+    if (input->pos) memmove(input->buffer, input->buffer + input->pos, rest);
+    input->pos = 0;
+    input->len = rest;
+
+    if (input->len == input->cap) {
+        size_t cap = input->cap ? input->cap * 2 : INPUT_CHUNK_SIZE;
+        char *buffer = realloc(input->buffer, cap);
+        if (!buffer) handle_error(NULL, "OUT OF MEMORY. ", -1);
+        input->buffer = buffer;
+        input->cap = cap;
+    }
+    input->data = input->buffer;
+
+    ssize_t got;
+    do got = read(input->fd, input->buffer + input->len, input->cap - input->len);
+    while (got < 0 && errno == EINTR);
+    if (got <= 0) input->eof = true;
+    else input->len += (size_t)got;
+}
+
+// true se la prossima lettura non deve aspettare la sorgente (riga intera già letta o fine input)
+bool input_line_ready(InputSource *input) {
+    if (!input->ready) input_prepare(input);
+    size_t available = input->len - input->pos;
+    return input->eof || (available && memchr(input->data + input->pos, '\n', available));
+}
+
+// Riga successiva senza il '\n' finale; false a fine input
+bool input_read_line(InputSource *input, const char **line, size_t *len) {
+    if (!input->ready) input_prepare(input);
+
+    for (;;) {
+        size_t available = input->len - input->pos;
+        const char *start = available ? input->data + input->pos : NULL;
+        const char *newline = start ? memchr(start, '\n', available) : NULL;
+        if (newline) {
+            *line = start;
+            *len = (size_t)(newline - start);
+            input->pos += *len + 1;
+            break;
+        }
+        if (input->eof) {
+            if (!available) return false;
+            *line = start; // ultima riga senza '\n'
+            *len = available;
+            input->pos = input->len;
+            break;
+        }
+        input_fill(input);
+    }
+
+    if (input->record) {
+        fwrite(*line, 1, *len, input->record);
+        fputc('\n', input->record);
+    }
+    return true;
+}
+
+// Rilascia mappatura, buffer, descrittore e file di registrazione
+void free_input(InputSource *input) {
+    if (input->map) munmap(input->map, input->map_size);
+    if (input->owns_fd) close(input->fd);
+    if (input->record) fclose(input->record);
+    free(input->buffer);
+    memset(input, 0, sizeof(*input));
+    input->fd = -1;
+}
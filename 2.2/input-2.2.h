@@ -0,0 +1,22 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "helper_function-2.2.h"
+
+// Dimensione dei blocchi letti da pipe e terminali
+#define INPUT_CHUNK_SIZE (64 * 1024)
+
+// Dichiarazione delle funzioni di input: unico percorso di lettura per LISTEN
+void input_from_fd(InputSource *input, int fd, bool owns_fd);
+void input_from_memory(InputSource *input, const char *data, size_t len);
+bool input_open_file(InputSource *input, const char *path);
+bool input_record(InputSource *input, const char *path);
+bool input_is_interactive(InputSource *input);
+bool input_line_ready(InputSource *input);
+bool input_read_line(InputSource *input, const char **line, size_t *len);
+void free_input(InputSource *input);
+
+#endif
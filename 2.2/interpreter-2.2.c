@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+
+#include "helper_function-2.2.h"
+#include "bytecode-2.2.h"
+#include "output-2.2.h"
+#include "cache-2.2.h"
+#include "interpreter-2.2.h"
+#include "input-2.2.h"
+#include "jit-2.2.h"
+
+/// ----------------- INTERPRETE -----------------
+// Compila l'intero script in un programma e poi lo esegue nel contesto indicato.
+// Se source è NULL lo script viene aperto da filename. Gli errori risalgono fin qui
+// (longjmp): restituisce il codice d'uscita dello script.
+static int interpret(Interpreter *interp, const char *filename, FILE *source) {
+    jmp_buf on_error;
+    jmp_buf *previous = interp->on_error;
+    FILE *volatile opened = NULL; // modificato dopo setjmp
+
+    Program *program = malloc(sizeof(Program));
+    if (!program) handle_error(NULL, "OUT OF MEMORY. ", -1);
+    init_program(program);
+
+    interp->exit_code = 0;
+    interp->on_error = &on_error;
+    if (setjmp(on_error) == 0) {
+        // Con la cache attiva un'immagine valida evita del tutto la compilazione
+        SourceKey key = {0, 0, false};
+        bool cached = filename && interp->use_cache && load_program_cache(interp, filename, program, &key);
+        if (!cached) {
+            FILE *stream = source;
+            if (!stream) {
+                opened = stream = fopen(filename, "r"); // Apre il file in modalità lettura
+                if (!stream) handle_error(interp, "COULD NOT OPEN FILE. ", -1); // Se fallisce errore
+            }
+            compile_file(interp, stream, program);
+            if (opened) fclose(opened);
+            opened = NULL;
+            if (filename && interp->use_cache) save_program_cache(interp, filename, program, &key);
+        }
+
+        if (interp->use_jit) program->jit = new_jit_cache();
+        execute_program(interp, program);
+    }
+    interp->on_error = previous;
+
+    if (opened) fclose(opened);
+    output_flush(interp);
+    free_program(program);
+    free(program);
+    return interp->exit_code;
+}
+
+// Esegue lo script contenuto nel file indicato
+int interpret_file(Interpreter *interp, const char *filename) {
+    return interpret(interp, filename, NULL);
+}
+
+// Esegue lo script letto da uno stream già aperto (che resta aperto)
+int interpret_stream(Interpreter *interp, FILE *source) {
+    return interpret(interp, NULL, source);
+}
+
+// Esegue lo script letto da fd mentre arriva: ogni riga viene compilata ed eseguita subito,
+// poi il programma viene svuotato. La memoria dipende dalla riga più lunga e dal numero di
+// variabili, non dalla lunghezza dello script. Prima di aspettare nuove righe l'output
+// viene svuotato, così chi scrive nella pipe vede i risultati senza ritardi.
+int interpret_streaming(Interpreter *interp, int fd) {
+    jmp_buf on_error;
+    jmp_buf *previous = interp->on_error;
+
+    Program *program = malloc(sizeof(Program));
+    if (!program) handle_error(NULL, "OUT OF MEMORY. ", -1);
+    init_program(program);
+    if (interp->use_jit) program->jit = new_jit_cache();
+    LineCompiler lc;
+    init_line_compiler(&lc);
+    InputSource source = {0};
+    input_from_fd(&source, fd, false);
+    TextBuffer line = {0}; // copia modificabile della riga corrente
+
+    interp->exit_code = 0;
+    interp->on_error = &on_error;
+    if (setjmp(on_error) == 0) {
+        const char *span;
+        size_t len;
+        bool running = true;
+        while (running) {
+            if (!input_line_ready(&source)) output_flush(interp);
+            if (!input_read_line(&source, &span, &len)) {
+                finish_source(&lc, program); // un IF rimasto aperto diventa un errore
+                execute_program(interp, program);
+                break;
+            }
+
+            line.len = 0;
+            text_append(&line, span, len);
+            compile_source_line(interp, &lc, program, line.data, line.len);
+            if (lc.block_count > 0) continue; // un IF si esegue solo quando ENDO chiude il blocco
+            running = execute_program(interp, program);
+            reset_program(program);
+        }
+    }
+    interp->on_error = previous;
+
+    output_flush(interp);
+    free(line.data);
+    free_input(&source);
+    free_line_compiler(&lc);
+    free_program(program);
+    free(program);
+    return interp->exit_code;
+}
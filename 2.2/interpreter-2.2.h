@@ -0,0 +1,12 @@
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include "helper_function-2.2.h"
+
+// Dichiarazione delle funzioni di esecuzione degli script
+int interpret_file(Interpreter *interp, const char *filename);
+int interpret_stream(Interpreter *interp, FILE *source);
+int interpret_streaming(Interpreter *interp, int fd);
+int run_batch(char **paths, int path_count, int jobs, bool use_cache, bool use_jit);
+
+#endif
@@ -0,0 +1,580 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "jit-2.2.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define JIT_NATIVE 1
+#else
+#define JIT_NATIVE 0
+#endif
+
+// Un'espressione calda viene tradotta una volta sola in una funzione x86-64 che legge gli slot
+// direttamente dalla tabella delle variabili. Il codice è specializzato sui tipi visti alla
+// compilazione: ogni lettura è protetta da una guardia e qualsiasi caso che l'interprete
+// segnalerebbe come errore (overflow, divisione per zero, ...) fa uscire dal codice nativo.
+// L'espressione viene allora rivalutata dall'interprete, che produce lo stesso messaggio:
+// le espressioni non hanno effetti collaterali, quindi rifarle è sempre corretto.
+
+// Oltre questo numero di uscite dalle guardie l'espressione torna per sempre all'interprete
+#define JIT_MAX_BAILS 64
+
+typedef enum {
+    JIT_COLD, JIT_READY, JIT_REJECTED
+} JitState;
+
+// Funzione generata: false = caso non gestito, da rivalutare con l'interprete
+typedef bool (*JitFunction)(const Variable *stack, CalcResult *result);
+
+typedef struct {
+    JitFunction code;
+    uint32_t hits;     // valutazioni interpretate finché l'espressione è fredda
+    uint32_t bails;    // uscite dal codice nativo
+    JitState state;
+} JitEntry;
+
+typedef struct {
+    void *address;
+    size_t size;
+} JitPage;
+
+struct JitCache {
+    JitEntry *entries; // indicizzate dalla prima operazione RPN dell'espressione
+    size_t entry_count;
+    JitPage *pages;    // una mappatura eseguibile per ogni espressione compilata
+    size_t page_count;
+    size_t page_cap;
+};
+
+static uint32_t jit_threshold = JIT_THRESHOLD;
+static pthread_once_t threshold_once = PTHREAD_ONCE_INIT;
+
+static void read_threshold(void) {
+    const char *forced = getenv("NOOBIE_JIT_THRESHOLD");
+    if (forced && *forced) jit_threshold = (uint32_t)strtoul(forced, NULL, 10);
+}
+
+// Il JIT genera codice solo su Linux x86-64; altrove --jit lascia tutto all'interprete
+bool jit_available(void) {
+    return JIT_NATIVE;
+}
+
+JitCache *new_jit_cache(void) {
+    JitCache *cache = calloc(1, sizeof(JitCache));
+    if (!cache) handle_error(NULL, "OUT OF MEMORY. ", -1);
+    pthread_once(&threshold_once, read_threshold);
+    return cache;
+}
+
+// Dimentica codice e contatori: le stesse posizioni conterranno altre espressioni (streaming)
+void clear_jit_cache(JitCache *cache) {
+    if (!cache) return;
+#if JIT_NATIVE
+    for (size_t i = 0; i < cache->page_count; i++) munmap(cache->pages[i].address, cache->pages[i].size);
+#endif
+    cache->page_count = 0;
+    if (cache->entry_count) memset(cache->entries, 0, cache->entry_count * sizeof(JitEntry));
+}
+
+void free_jit_cache(JitCache *cache) {
+    if (!cache) return;
+    clear_jit_cache(cache);
+    free(cache->entries);
+    free(cache->pages);
+    free(cache);
+}
+
+#if JIT_NATIVE
+// -------------------------- EMISSIONE x86-64 --------------------------
+
+// Registri usati (numerazione della codifica): rax, rcx, rdx per gli interi, xmm0-2 per i double.
+// rdi = tabella delle variabili, rsi = risultato, [rsp + 8*i] = i-esimo valore della pila RPN
+enum { RAX = 0, RCX = 1, RDX = 2 };
+enum { XMM0 = 0, XMM1 = 1, XMM2 = 2 };
+
+// Codici di condizione di jcc/setcc
+enum {
+    CC_O = 0x0, CC_B = 0x2, CC_AE = 0x3, CC_E = 0x4, CC_NE = 0x5, CC_A = 0x7, CC_P = 0xA, CC_NP = 0xB,
+    CC_L = 0xC, CC_GE = 0xD, CC_LE = 0xE, CC_G = 0xF
+};
+
+typedef struct {
+    uint8_t *code;
+    size_t len;
+    size_t cap;
+    size_t *bails;     // spiazzamenti rel32 da collegare all'uscita verso l'interprete
+    size_t bail_count;
+    size_t bail_cap;
+} Emitter;
+
+static void emit_bytes(Emitter *e, const uint8_t *bytes, size_t n) {
+    if (e->len + n > e->cap) {
+        size_t cap = e->cap ? e->cap * 2 : 256;
+        while (e->len + n > cap) cap *= 2;
+        uint8_t *code = realloc(e->code, cap);
+        if (!code) handle_error(NULL, "OUT OF MEMORY. ", -1);
+        e->code = code;
+        e->cap = cap;
+    }
+    memcpy(e->code + e->len, bytes, n);
+    e->len += n;
+}
+
+#define EMIT(e, ...) do { const uint8_t bytes_[] = {__VA_ARGS__}; emit_bytes(e, bytes_, sizeof(bytes_)); } while (0)
+
+static void emit_u32(Emitter *e, uint32_t value) {
+    emit_bytes(e, (const uint8_t *)&value, 4);
+}
+
+static void emit_u64(Emitter *e, uint64_t value) {
+    emit_bytes(e, (const uint8_t *)&value, 8);
+}
+
+// Opcode con operando [rsp + 8*index] (ModRM mod=10 rm=100, SIB 0x24)
+static void emit_stack_operand(Emitter *e, const uint8_t *opcode, size_t n, int reg, int index) {
+    emit_bytes(e, opcode, n);
+    EMIT(e, (uint8_t)(0x84 | reg << 3), 0x24);
+    emit_u32(e, (uint32_t)(index * 8));
+}
+
+// Opcode con operando [rdi + disp32] (ModRM mod=10 rm=111)
+static void emit_table_operand(Emitter *e, const uint8_t *opcode, size_t n, int reg, int32_t disp) {
+    emit_bytes(e, opcode, n);
+    EMIT(e, (uint8_t)(0x87 | reg << 3));
+    emit_u32(e, (uint32_t)disp);
+}
+
+static void load_reg(Emitter *e, int reg, int index) {
+    static const uint8_t mov[] = {0x48, 0x8B};
+    emit_stack_operand(e, mov, sizeof(mov), reg, index);
+}
+
+static void store_rax(Emitter *e, int index) {
+    static const uint8_t mov[] = {0x48, 0x89};
+    emit_stack_operand(e, mov, sizeof(mov), RAX, index);
+}
+
+// Salto condizionato in avanti: restituisce lo spiazzamento da risolvere con patch_here
+static size_t emit_jcc(Emitter *e, int cc) {
+    EMIT(e, 0x0F, (uint8_t)(0x80 | cc));
+    emit_u32(e, 0);
+    return e->len - 4;
+}
+
+static size_t emit_jmp(Emitter *e) {
+    EMIT(e, 0xE9);
+    emit_u32(e, 0);
+    return e->len - 4;
+}
+
+static void patch_here(Emitter *e, size_t at) {
+    uint32_t rel = (uint32_t)(e->len - (at + 4));
+    memcpy(e->code + at, &rel, 4);
+}
+
+// Salto condizionato verso l'uscita comune "rivaluta con l'interprete"
+static void emit_bail_if(Emitter *e, int cc) {
+    size_t at = emit_jcc(e, cc);
+    if (e->bail_count == e->bail_cap) {
+        size_t cap = e->bail_cap ? e->bail_cap * 2 : 16;
+        size_t *bails = realloc(e->bails, cap * sizeof(size_t));
+        if (!bails) handle_error(NULL, "OUT OF MEMORY. ", -1);
+        e->bails = bails;
+        e->bail_cap = cap;
+    }
+    e->bails[e->bail_count++] = at;
+}
+
+// setcc al (oppure cl)
+static void emit_setcc(Emitter *e, int cc, int reg) {
+    EMIT(e, 0x0F, (uint8_t)(0x90 | cc), (uint8_t)(0xC0 | reg));
+}
+
+// Valore della pila come double in xmm (gli INT e i BOOL vengono convertiti come fa l'interprete)
+static void load_double(Emitter *e, int xmm, int index, VarType type) {
+    load_reg(e, RAX, index);
+    if (type == TYPE_FLOAT) EMIT(e, 0x66, 0x48, 0x0F, 0x6E, (uint8_t)(0xC0 | xmm << 3)); // movq xmm, rax
+    else EMIT(e, 0xF2, 0x48, 0x0F, 0x2A, (uint8_t)(0xC0 | xmm << 3));                    // cvtsi2sd xmm, rax
+}
+
+static void store_xmm0(Emitter *e, int index) {
+    EMIT(e, 0x66, 0x48, 0x0F, 0x7E, 0xC0); // movq rax, xmm0
+    store_rax(e, index);
+}
+
+// Sostituisce il valore con il suo valore di verità 0/1 (0 e 0.0 sono falsi, NaN è vero)
+static void emit_truth(Emitter *e, int index, VarType type) {
+    if (type == TYPE_BOOL) return;
+    load_reg(e, RAX, index);
+    if (type == TYPE_INT) {
+        EMIT(e, 0x48, 0x85, 0xC0); // test rax, rax
+        emit_setcc(e, CC_NE, RAX);
+    } else {
+        EMIT(e, 0x66, 0x48, 0x0F, 0x6E, 0xC0); // movq xmm0, rax
+        EMIT(e, 0x66, 0x0F, 0x57, 0xD2);       // xorpd xmm2, xmm2
+        EMIT(e, 0x66, 0x0F, 0x2E, 0xC2);       // ucomisd xmm0, xmm2
+        emit_setcc(e, CC_NE, RAX);
+        emit_setcc(e, CC_P, RCX);
+        EMIT(e, 0x08, 0xC8);                   // or al, cl
+    }
+    EMIT(e, 0x0F, 0xB6, 0xC0); // movzx eax, al
+    store_rax(e, index);
+}
+
+// Lettura di una variabile: guardie su dichiarazione e tipo, poi il valore a 64 bit
+static bool emit_variable(Emitter *e, int index, int slot, VarType type) {
+    if (slot < 0 || (size_t)slot > (INT32_MAX - sizeof(Variable)) / sizeof(Variable)) return false;
+    int32_t base = (int32_t)((size_t)slot * sizeof(Variable));
+
+    static const uint8_t cmp_byte[] = {0x80};
+    emit_table_operand(e, cmp_byte, sizeof(cmp_byte), 7, base + (int32_t)offsetof(Variable, is_declared));
+    EMIT(e, 0x00);
+    emit_bail_if(e, CC_E);
+
+    static const uint8_t cmp_dword[] = {0x81};
+    emit_table_operand(e, cmp_dword, sizeof(cmp_dword), 7, base + (int32_t)offsetof(Variable, type));
+    emit_u32(e, (uint32_t)type);
+    emit_bail_if(e, CC_NE);
+
+    static const uint8_t mov[] = {0x48, 0x8B};
+    static const uint8_t movzx[] = {0x0F, 0xB6};
+    if (type == TYPE_BOOL) emit_table_operand(e, movzx, sizeof(movzx), RAX, base + (int32_t)offsetof(Variable, value));
+    else emit_table_operand(e, mov, sizeof(mov), RAX, base + (int32_t)offsetof(Variable, value));
+    store_rax(e, index);
+    return true;
+}
+
+// Divisione: sempre FLOAT; tra interi il quoziente esatto quando il resto è zero (come divide_int)
+static void emit_divide(Emitter *e, int l, VarType left, int r, VarType right) {
+    if (left == TYPE_FLOAT || right == TYPE_FLOAT) {
+        load_double(e, XMM0, l, left);
+        load_double(e, XMM1, r, right);
+        EMIT(e, 0x66, 0x0F, 0x57, 0xD2); // xorpd xmm2, xmm2
+        EMIT(e, 0x66, 0x0F, 0x2E, 0xCA); // ucomisd xmm1, xmm2
+        size_t nan = emit_jcc(e, CC_P);
+        emit_bail_if(e, CC_E);           // DIVISION BY ZERO
+        patch_here(e, nan);
+        EMIT(e, 0xF2, 0x0F, 0x5E, 0xC1); // divsd xmm0, xmm1
+        store_xmm0(e, l);
+        return;
+    }
+
+    load_reg(e, RCX, r);
+    EMIT(e, 0x48, 0x85, 0xC9);              // test rcx, rcx
+    emit_bail_if(e, CC_E);                  // DIVISION BY ZERO
+    load_reg(e, RAX, l);
+    EMIT(e, 0x48, 0x83, 0xF9, 0xFF);        // cmp rcx, -1
+    size_t not_minus_one = emit_jcc(e, CC_NE);
+    EMIT(e, 0xF2, 0x48, 0x0F, 0x2A, 0xC0);  // cvtsi2sd xmm0, rax
+    EMIT(e, 0x66, 0x48, 0x0F, 0x7E, 0xC0);  // movq rax, xmm0
+    EMIT(e, 0x48, 0x0F, 0xBA, 0xF8, 0x3F);  // btc rax, 63: -(double)l
+    size_t negated = emit_jmp(e);
+
+    patch_here(e, not_minus_one);
+    EMIT(e, 0x48, 0x99);                    // cqo
+    EMIT(e, 0x48, 0xF7, 0xF9);              // idiv rcx
+    EMIT(e, 0x48, 0x85, 0xD2);              // test rdx, rdx
+    size_t inexact = emit_jcc(e, CC_NE);
+    EMIT(e, 0xF2, 0x48, 0x0F, 0x2A, 0xC0);  // cvtsi2sd xmm0, rax
+    size_t exact = emit_jmp(e);
+
+    patch_here(e, inexact);
+    load_reg(e, RAX, l);
+    EMIT(e, 0xF2, 0x48, 0x0F, 0x2A, 0xC0);  // cvtsi2sd xmm0, rax
+    EMIT(e, 0xF2, 0x48, 0x0F, 0x2A, 0xC9);  // cvtsi2sd xmm1, rcx
+    EMIT(e, 0xF2, 0x0F, 0x5E, 0xC1);        // divsd xmm0, xmm1
+
+    patch_here(e, exact);
+    EMIT(e, 0x66, 0x48, 0x0F, 0x7E, 0xC0);  // movq rax, xmm0
+    patch_here(e, negated);
+    store_rax(e, l);
+}
+
+// Modulo tra interi (modulo_int): divisore -1 dà 0, zero torna all'interprete
+static void emit_modulo(Emitter *e, int l, int r) {
+    load_reg(e, RCX, r);
+    EMIT(e, 0x48, 0x85, 0xC9);       // test rcx, rcx
+    emit_bail_if(e, CC_E);           // MODULO BY ZERO
+    EMIT(e, 0x31, 0xC0);             // xor eax, eax
+    EMIT(e, 0x48, 0x83, 0xF9, 0xFF); // cmp rcx, -1
+    size_t minus_one = emit_jcc(e, CC_E);
+    load_reg(e, RAX, l);
+    EMIT(e, 0x48, 0x99);             // cqo
+    EMIT(e, 0x48, 0xF7, 0xF9);       // idiv rcx
+    EMIT(e, 0x48, 0x89, 0xD0);       // mov rax, rdx
+    patch_here(e, minus_one);
+    store_rax(e, l);
+}
+
+// Confronto: interi con cmp, double con ucomisd (con NaN solo != è vero, come in C)
+static void emit_compare(Emitter *e, OperatorKind op, int l, VarType left, int r, VarType right) {
+    if (left != TYPE_FLOAT && right != TYPE_FLOAT) {
+        static const int int_cc[] = {[OPERATOR_EQ] = CC_E, [OPERATOR_NE] = CC_NE, [OPERATOR_LT] = CC_L,
+                                     [OPERATOR_GT] = CC_G, [OPERATOR_LE] = CC_LE, [OPERATOR_GE] = CC_GE};
+        load_reg(e, RAX, l);
+        load_reg(e, RCX, r);
+        EMIT(e, 0x48, 0x39, 0xC8); // cmp rax, rcx
+        emit_setcc(e, int_cc[op], RAX);
+    } else {
+        load_double(e, XMM0, l, left);
+        load_double(e, XMM1, r, right);
+        switch (op) {
+            case OPERATOR_GT:
+            case OPERATOR_GE:
+                EMIT(e, 0x66, 0x0F, 0x2E, 0xC1); // ucomisd xmm0, xmm1
+                emit_setcc(e, op == OPERATOR_GT ? CC_A : CC_AE, RAX);
+                break;
+            case OPERATOR_LT:
+            case OPERATOR_LE:
+                EMIT(e, 0x66, 0x0F, 0x2E, 0xC8); // ucomisd xmm1, xmm0
+                emit_setcc(e, op == OPERATOR_LT ? CC_A : CC_AE, RAX);
+                break;
+            case OPERATOR_EQ:
+                EMIT(e, 0x66, 0x0F, 0x2E, 0xC1);
+                emit_setcc(e, CC_E, RAX);
+                emit_setcc(e, CC_NP, RCX);
+                EMIT(e, 0x20, 0xC8); // and al, cl
+                break;
+            default: // OPERATOR_NE
+                EMIT(e, 0x66, 0x0F, 0x2E, 0xC1);
+                emit_setcc(e, CC_NE, RAX);
+                emit_setcc(e, CC_P, RCX);
+                EMIT(e, 0x08, 0xC8); // or al, cl
+                break;
+        }
+    }
+    EMIT(e, 0x0F, 0xB6, 0xC0); // movzx eax, al
+    store_rax(e, l);
+}
+
+// Operatore binario sui valori l = sp-2 e r = sp-1; false se non è gestito (torna all'interprete)
+static bool emit_binary(Emitter *e, OperatorKind op, int l, VarType *types) {
+    int r = l + 1;
+    VarType left = types[l], right = types[r];
+    bool is_float = left == TYPE_FLOAT || right == TYPE_FLOAT;
+
+    switch (op) {
+        case OPERATOR_ADD:
+        case OPERATOR_SUB:
+        case OPERATOR_MUL:
+            if (is_float) {
+                static const uint8_t sse[] = {[OPERATOR_ADD] = 0x58, [OPERATOR_SUB] = 0x5C, [OPERATOR_MUL] = 0x59};
+                load_double(e, XMM0, l, left);
+                load_double(e, XMM1, r, right);
+                EMIT(e, 0xF2, 0x0F, sse[op], 0xC1); // addsd/subsd/mulsd xmm0, xmm1
+                store_xmm0(e, l);
+                types[l] = TYPE_FLOAT;
+            } else {
+                load_reg(e, RAX, l);
+                load_reg(e, RCX, r);
+                if (op == OPERATOR_ADD) EMIT(e, 0x48, 0x01, 0xC8);            // add rax, rcx
+                else if (op == OPERATOR_SUB) EMIT(e, 0x48, 0x29, 0xC8);       // sub rax, rcx
+                else EMIT(e, 0x48, 0x0F, 0xAF, 0xC1);                         // imul rax, rcx
+                emit_bail_if(e, CC_O); // INTEGER OVERFLOW
+                store_rax(e, l);
+                types[l] = TYPE_INT;
+            }
+            return true;
+
+        case OPERATOR_DIV:
+            emit_divide(e, l, left, r, right);
+            types[l] = TYPE_FLOAT;
+            return true;
+
+        case OPERATOR_MOD:
+            if (left != TYPE_INT || right != TYPE_INT) return false; // sempre un errore
+            emit_modulo(e, l, r);
+            return true;
+
+        case OPERATOR_EQ:
+        case OPERATOR_NE:
+        case OPERATOR_LT:
+        case OPERATOR_GT:
+        case OPERATOR_LE:
+        case OPERATOR_GE:
+            emit_compare(e, op, l, left, r, right);
+            types[l] = TYPE_BOOL;
+            return true;
+
+        case OPERATOR_AND:
+        case OPERATOR_OR:
+        case OPERATOR_XOR:
+            emit_truth(e, l, left);
+            emit_truth(e, r, right);
+            load_reg(e, RAX, l);
+            load_reg(e, RCX, r);
+            if (op == OPERATOR_AND) EMIT(e, 0x48, 0x21, 0xC8);      // and rax, rcx
+            else if (op == OPERATOR_OR) EMIT(e, 0x48, 0x09, 0xC8);  // or rax, rcx
+            else EMIT(e, 0x48, 0x31, 0xC8);                         // xor rax, rcx
+            store_rax(e, l);
+            types[l] = TYPE_BOOL;
+            return true;
+
+        default: // potenze (pow della libm) e operatori sconosciuti
+            return false;
+    }
+}
+
+static bool emit_unary(Emitter *e, OperatorKind op, int index, VarType *types) {
+    switch (op) {
+        case OPERATOR_SUB:
+            if (types[index] == TYPE_BOOL) return false;
+            load_reg(e, RAX, index);
+            if (types[index] == TYPE_INT) {
+                EMIT(e, 0x48, 0xF7, 0xD8);             // neg rax
+                emit_bail_if(e, CC_O);                 // -INT64_MIN
+            } else
+                EMIT(e, 0x48, 0x0F, 0xBA, 0xF8, 0x3F); // btc rax, 63
+            store_rax(e, index);
+            return true;
+        case OPERATOR_ADD:
+            return types[index] != TYPE_BOOL;
+        case OPERATOR_NOT:
+            emit_truth(e, index, types[index]);
+            load_reg(e, RAX, index);
+            EMIT(e, 0x48, 0x83, 0xF0, 0x01); // xor rax, 1
+            store_rax(e, index);
+            types[index] = TYPE_BOOL;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Traduce il codice RPN; i tipi delle variabili sono quelli che hanno adesso
+static bool emit_expression(Emitter *e, Interpreter *interp, const ExprOp *ops, uint32_t count) {
+    VarType types[EXPR_STACK_SIZE];
+    int sp = 0, depth = 0;
+
+    // Prima passata: profondità massima della pila, per riservare il frame
+    for (uint32_t i = 0; i < count; i++) {
+        if (ops[i].type == EXPR_CONSTANT || ops[i].type == EXPR_VARIABLE) sp++;
+        else if (ops[i].type == EXPR_BINARY) sp--;
+        if (sp > depth) depth = sp;
+    }
+    if (sp != 1 || depth > EXPR_STACK_SIZE) return false;
+    uint32_t frame = (uint32_t)((depth * 8 + 15) & ~15);
+
+    EMIT(e, 0x48, 0x81, 0xEC); // sub rsp, frame
+    emit_u32(e, frame);
+
+    sp = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const ExprOp *op = &ops[i];
+        switch (op->type) {
+            case EXPR_CONSTANT: {
+                uint64_t bits = 0;
+                if (op->value.type == TYPE_INT) memcpy(&bits, &op->value.value.i_val, 8);
+                else if (op->value.type == TYPE_FLOAT) memcpy(&bits, &op->value.value.f_val, 8);
+                else if (op->value.type == TYPE_BOOL) bits = op->value.value.b_val;
+                else return false;
+                EMIT(e, 0x48, 0xB8); // mov rax, imm64
+                emit_u64(e, bits);
+                store_rax(e, sp);
+                types[sp++] = op->value.type;
+                break;
+            }
+            case EXPR_VARIABLE: {
+                const Variable *var = &interp->stack[op->slot];
+                if (!var->is_declared || (var->type != TYPE_INT && var->type != TYPE_FLOAT && var->type != TYPE_BOOL))
+                    return false;
+                if (!emit_variable(e, sp, op->slot, var->type)) return false;
+                types[sp++] = var->type;
+                break;
+            }
+            case EXPR_UNARY:
+                if (!emit_unary(e, op->op, sp - 1, types)) return false;
+                break;
+            case EXPR_BINARY:
+                sp--;
+                if (!emit_binary(e, op->op, sp - 1, types)) return false;
+                break;
+        }
+    }
+
+    // Risultato: tipo e 64 bit del valore in *rsi
+    EMIT(e, 0xC7, 0x86); // mov dword [rsi + disp32], imm32
+    emit_u32(e, (uint32_t)offsetof(CalcResult, type));
+    emit_u32(e, (uint32_t)types[0]);
+    load_reg(e, RAX, 0);
+    EMIT(e, 0x48, 0x89, 0x86); // mov [rsi + disp32], rax
+    emit_u32(e, (uint32_t)offsetof(CalcResult, value));
+    EMIT(e, 0xB8, 0x01, 0x00, 0x00, 0x00); // mov eax, 1
+    EMIT(e, 0x48, 0x81, 0xC4);             // add rsp, frame
+    emit_u32(e, frame);
+    EMIT(e, 0xC3);                         // ret
+
+    // Uscita comune verso l'interprete
+    for (size_t i = 0; i < e->bail_count; i++) patch_here(e, e->bails[i]);
+    EMIT(e, 0x31, 0xC0);       // xor eax, eax
+    EMIT(e, 0x48, 0x81, 0xC4); // add rsp, frame
+    emit_u32(e, frame);
+    EMIT(e, 0xC3);
+    return true;
+}
+
+// Copia il codice in una mappatura che diventa eseguibile (mai scrivibile ed eseguibile insieme)
+static JitFunction install_code(JitCache *cache, const uint8_t *code, size_t len) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = (len + page - 1) / page * page;
+    void *address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (address == MAP_FAILED) return NULL;
+    memcpy(address, code, len);
+    if (mprotect(address, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(address, size);
+        return NULL;
+    }
+
+    if (cache->page_count == cache->page_cap) {
+        size_t cap = cache->page_cap ? cache->page_cap * 2 : 16;
+        JitPage *pages = realloc(cache->pages, cap * sizeof(JitPage));
+        if (!pages) handle_error(NULL, "OUT OF MEMORY. ", -1);
+        cache->pages = pages;
+        cache->page_cap = cap;
+    }
+    cache->pages[cache->page_count++] = (JitPage){address, size};
+    return (JitFunction)address;
+}
+
+static void compile_entry(Interpreter *interp, JitCache *cache, JitEntry *entry, const ExprOp *ops, uint32_t count) {
+    Emitter e = {0};
+    entry->state = JIT_REJECTED;
+    if (emit_expression(&e, interp, ops, count) && (entry->code = install_code(cache, e.code, e.len)))
+        entry->state = JIT_READY;
+    free(e.code);
+    free(e.bails);
+}
+#endif
+
+// Valuta un'espressione: in codice nativo se è calda e tradotta, altrimenti con l'interprete
+CalcResult jit_evaluate(Interpreter *interp, JitCache *cache, const ExprCode *exprs, uint32_t first, uint32_t count, int line_number) {
+    const ExprOp *ops = exprs->ops + first;
+#if JIT_NATIVE
+    if (first >= cache->entry_count) {
+        size_t entry_count = exprs->count > first ? exprs->count : first + 1;
+        JitEntry *entries = realloc(cache->entries, entry_count * sizeof(JitEntry));
+        if (!entries) handle_error(NULL, "OUT OF MEMORY. ", line_number);
+        memset(entries + cache->entry_count, 0, (entry_count - cache->entry_count) * sizeof(JitEntry));
+        cache->entries = entries;
+        cache->entry_count = entry_count;
+    }
+
+    JitEntry *entry = &cache->entries[first];
+    if (entry->state == JIT_COLD && ++entry->hits >= jit_threshold) compile_entry(interp, cache, entry, ops, count);
+    if (entry->state == JIT_READY) {
+        CalcResult result;
+        if (entry->code(interp->stack, &result)) return result;
+        if (++entry->bails >= JIT_MAX_BAILS) entry->state = JIT_REJECTED;
+    }
+#else
+    (void)cache;
+#endif
+    return evaluate_compiled(interp, ops, count, line_number);
+}
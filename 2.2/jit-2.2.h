@@ -0,0 +1,24 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "helper_function-2.2.h"
+#include "calc_parser.h"
+
+// Valutazioni interpretate prima che un'espressione venga tradotta in codice nativo
+// (NOOBIE_JIT_THRESHOLD la cambia, 0 = compila subito: confronti con l'interprete)
+#define JIT_THRESHOLD 1000
+
+// Codice nativo e contatori delle espressioni di un programma (--jit)
+typedef struct JitCache JitCache;
+
+// Dichiarazione delle funzioni del JIT
+JitCache *new_jit_cache(void);
+void clear_jit_cache(JitCache *cache);
+void free_jit_cache(JitCache *cache);
+bool jit_available(void);
+CalcResult jit_evaluate(Interpreter *interp, JitCache *cache, const ExprCode *exprs, uint32_t first, uint32_t count, int line_number);
+
+#endif
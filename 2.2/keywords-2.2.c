@@ -0,0 +1,195 @@
+// GENERATO DA gen_keywords.py - NON MODIFICARE A MANO
+#include <ctype.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "keywords-2.2.h"
+
+#define KW_TABLE_SIZE 128
+#define KW_MIN_LENGTH 2
+#define KW_MAX_LENGTH 9
+
+// Voce della tabella: parola in maiuscolo, lunghezza ed enum
+typedef struct {
+    const char *word;
+    size_t len;
+    Keyword kw;
+} KeywordEntry;
+
+static const KeywordEntry keyword_table[KW_TABLE_SIZE] = {
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"CLEAR", 5, KW_CLEAR},
+    {"DOT", 3, KW_DOT},
+    {NULL, 0, KW_NONE},
+    {"SUM", 3, KW_SUM},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"AND", 3, KW_AND},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"OR", 2, KW_OR},
+    {"EXIT", 4, KW_EXIT},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"INT", 3, KW_INT},
+    {NULL, 0, KW_NONE},
+    {"CALC", 4, KW_CALC},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"CONST", 5, KW_CONST},
+    {"IF", 2, KW_IF},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"LISTEN", 6, KW_LISTEN},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"NOT", 3, KW_NOT},
+    {NULL, 0, KW_NONE},
+    {"FLOAT", 5, KW_FLOAT},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"SET", 3, KW_SET},
+    {"STR", 3, KW_STR},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"MAX", 3, KW_MAX},
+    {NULL, 0, KW_NONE},
+    {"ELSE", 4, KW_ELSE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"XOR", 3, KW_XOR},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"FALSE", 5, KW_FALSE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"ARRAY", 5, KW_ARRAY},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"LINE", 4, KW_LINE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"SAY", 3, KW_SAY},
+    {NULL, 0, KW_NONE},
+    {"DECREMENT", 9, KW_DECREMENT},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"REPEAT", 6, KW_REPEAT},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"BOOL", 4, KW_BOOL},
+    {"DO", 2, KW_DO},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"INCREMENT", 9, KW_INCREMENT},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"FILL", 4, KW_FILL},
+    {NULL, 0, KW_NONE},
+    {"TRUE", 4, KW_TRUE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"ENDO", 4, KW_ENDO},
+    {NULL, 0, KW_NONE},
+    {"WHILE", 5, KW_WHILE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"MIN", 3, KW_MIN},
+    {NULL, 0, KW_NONE},
+    {NULL, 0, KW_NONE},
+    {"CHAR", 4, KW_CHAR},
+    {NULL, 0, KW_NONE},
+    {"MEAN", 4, KW_MEAN},
+    {"MAP", 3, KW_MAP},
+};
+
+// Funzione hash perfetta: nessuna collisione tra le parole chiave
+static unsigned keyword_hash(const char *word, size_t len) {
+    unsigned first = (unsigned)toupper((unsigned char)word[0]);
+    unsigned last = (unsigned)toupper((unsigned char)word[len - 1]);
+    unsigned middle = (unsigned)toupper((unsigned char)word[len / 2]);
+    return (first * 3u + last * 7u + middle + (unsigned)len * 13u) & (KW_TABLE_SIZE - 1);
+}
+
+// Restituisce la parola chiave corrispondente (senza distinzione maiuscole/minuscole) o KW_NONE
+Keyword lookup_keyword(const char *word, size_t len) {
+    if (len < KW_MIN_LENGTH || len > KW_MAX_LENGTH) return KW_NONE;
+
+    const KeywordEntry *entry = &keyword_table[keyword_hash(word, len)];
+    if (entry->len != len) return KW_NONE;
+    for (size_t i = 0; i < len; i++) {
+        if (toupper((unsigned char)word[i]) != entry->word[i]) return KW_NONE;
+    }
+    return entry->kw;
+}
+
+// Parole chiave che non possono essere usate come nome di variabile
+static const bool reserved_table[KW_COUNT] = {
+    [KW_INT] = true,
+    [KW_FLOAT] = true,
+    [KW_CHAR] = true,
+    [KW_STR] = true,
+    [KW_BOOL] = true,
+    [KW_SET] = true,
+    [KW_CONST] = true,
+    [KW_SAY] = true,
+    [KW_LISTEN] = true,
+    [KW_EXIT] = true,
+    [KW_LINE] = true,
+    [KW_CLEAR] = true,
+    [KW_CALC] = true,
+    [KW_ARRAY] = true,
+    [KW_IF] = true,
+    [KW_ELSE] = true,
+    [KW_ENDO] = true,
+    [KW_WHILE] = true,
+    [KW_REPEAT] = true,
+};
+
+bool is_reserved(Keyword kw) {
+    return reserved_table[kw];
+}
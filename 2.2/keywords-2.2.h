@@ -0,0 +1,53 @@
+// GENERATO DA gen_keywords.py - NON MODIFICARE A MANO
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// Parole chiave del linguaggio (comandi, tipi, operatori logici, booleani)
+typedef enum {
+    KW_NONE,
+    KW_INT,
+    KW_FLOAT,
+    KW_CHAR,
+    KW_STR,
+    KW_BOOL,
+    KW_SET,
+    KW_CONST,
+    KW_SAY,
+    KW_LISTEN,
+    KW_EXIT,
+    KW_LINE,
+    KW_CLEAR,
+    KW_CALC,
+    KW_INCREMENT,
+    KW_DECREMENT,
+    KW_ARRAY,
+    KW_FILL,
+    KW_MAP,
+    KW_SUM,
+    KW_MIN,
+    KW_MAX,
+    KW_MEAN,
+    KW_DOT,
+    KW_IF,
+    KW_DO,
+    KW_ELSE,
+    KW_ENDO,
+    KW_WHILE,
+    KW_REPEAT,
+    KW_AND,
+    KW_OR,
+    KW_XOR,
+    KW_NOT,
+    KW_TRUE,
+    KW_FALSE,
+    KW_COUNT
+} Keyword;
+
+// Dichiarazione delle funzioni di ricerca
+Keyword lookup_keyword(const char *word, size_t len);
+bool is_reserved(Keyword kw);
+
+#endif
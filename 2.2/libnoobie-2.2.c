@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+
+#include "libnoobie-2.2.h"
+#include "helper_function-2.2.h"
+#include "calc_parser.h"
+#include "interpreter-2.2.h"
+#include "array-2.2.h"
+#include "string-2.2.h"
+#include "input-2.2.h"
+
+// I tipi pubblici rispecchiano VarType: la conversione è un semplice cast
+_Static_assert((int)NOOBIE_INT == (int)TYPE_INT && (int)NOOBIE_BOOL == (int)TYPE_BOOL,
+               "NoobieType must match VarType");
+
+// -------------------------- CONTESTO --------------------------
+
+// Nuovo contesto: output su stdout finché non viene impostato un sink, errori catturati
+NoobieContext *noobie_create(void) {
+    Interpreter *interp = malloc(sizeof(Interpreter));
+    if (!interp) return NULL;
+    init_interpreter(interp);
+    interp->error_fd = -1;
+    input_from_fd(&interp->input, -1, false); // LISTEN non ha input finché non viene impostato
+    return interp;
+}
+
+void noobie_destroy(NoobieContext *ctx) {
+    if (!ctx) return;
+    free_interpreter(ctx);
+    free(ctx);
+}
+
+// Instrada l'output verso il chiamante (NULL = di nuovo su stdout)
+void noobie_set_output(NoobieContext *ctx, NoobieSink sink, void *user_data) {
+    ctx->sink = sink;
+    ctx->sink_data = user_data;
+}
+
+// Risposte per LISTEN, una per riga; il testo deve restare valido finché lo script lo legge
+void noobie_set_input(NoobieContext *ctx, const char *data, size_t len) {
+    if (data && len == NOOBIE_NUL_TERMINATED) len = strlen(data);
+    input_from_memory(&ctx->input, data, len);
+}
+
+// Ultimo messaggio d'errore ("" se l'ultima chiamata è riuscita)
+const char *noobie_last_error(const NoobieContext *ctx) {
+    return ctx->errors.data ? ctx->errors.data : "";
+}
+
+static void clear_error(NoobieContext *ctx) {
+    ctx->errors.len = 0;
+    text_append(&ctx->errors, "", 0);
+}
+
+// Errore di una chiamata dell'API, nello stesso formato dei messaggi dell'interprete
+static int api_error(NoobieContext *ctx, const char *message) {
+    char text[256];
+    int len = snprintf(text, sizeof(text), "LINE -1 -> ERROR: %s\n", message);
+    if (len >= (int)sizeof(text)) len = sizeof(text) - 1;
+    text_append(&ctx->errors, text, len);
+    return NOOBIE_ERROR;
+}
+
+// -------------------------- VALUTAZIONE --------------------------
+
+// Esegue uno script in memoria; le variabili restano nel contesto per le chiamate successive
+int noobie_eval(NoobieContext *ctx, const char *source, size_t len) {
+    clear_error(ctx);
+    if (len == NOOBIE_NUL_TERMINATED) len = strlen(source);
+    if (len == 0) return NOOBIE_OK;
+
+    FILE *stream = fmemopen((void *)source, len, "r");
+    if (!stream) return api_error(ctx, "COULD NOT READ SCRIPT FROM MEMORY. ");
+    int status = interpret_stream(ctx, stream);
+    fclose(stream);
+    return status == 0 ? NOOBIE_OK : NOOBIE_ERROR;
+}
+
+// Valuta una singola espressione come farebbe CALC, restituendo il risultato invece di stamparlo
+int noobie_calc(NoobieContext *ctx, const char *expression, NoobieValue *result) {
+    jmp_buf on_error;
+    jmp_buf *previous = ctx->on_error;
+
+    clear_error(ctx);
+    ExprCode *code = malloc(sizeof(ExprCode));
+    if (!code) return api_error(ctx, "OUT OF MEMORY. ");
+    init_expr_code(code);
+
+    ctx->exit_code = 0;
+    ctx->on_error = &on_error;
+    if (setjmp(on_error) == 0) {
+        const char *error = compile_expression(ctx, expression, code);
+        if (error) handle_error(ctx, error, -1);
+
+        CalcResult value = evaluate_compiled(ctx, code->ops, code->count, -1);
+        result->type = (NoobieType)value.type;
+        switch (value.type) {
+            case TYPE_INT: result->as.i_val = value.value.i_val; break;
+            case TYPE_FLOAT: result->as.f_val = value.value.f_val; break;
+            default: result->as.b_val = value.value.b_val; break;
+        }
+    }
+    ctx->on_error = previous;
+
+    free_expr_code(code);
+    free(code);
+    return ctx->exit_code == 0 ? NOOBIE_OK : NOOBIE_ERROR;
+}
+
+// -------------------------- VARIABILI --------------------------
+
+// Dichiara o sovrascrive una variabile (le costanti non si possono modificare)
+int noobie_set(NoobieContext *ctx, const char *name, NoobieValue value) {
+    clear_error(ctx);
+    if (!name || !*name || is_reserved_keyword(name))
+        return api_error(ctx, "VARIABLE NAME CAN NOT BE A RESERVED KEYWORDS. ");
+    if ((unsigned)value.type > NOOBIE_BOOL) return api_error(ctx, "UNSUPPORTED TYPE IN SET. ");
+
+    int slot = intern_variable(ctx, name); // può riallocare la stack
+    Variable *var = &ctx->stack[slot];
+    if (var->is_declared && var->is_const) return api_error(ctx, "CAN NOT MODIFY A CONSTANT VARIABLE. ");
+    if (var->is_declared && is_array_type(var->type)) free_array(var->value.a_val);
+    // Una STR che resta STR riusa il proprio buffer, altrimenti si riparte dalla stringa vuota
+    if (!var->is_declared || var->type != TYPE_STR || value.type != NOOBIE_STR) memset(&var->value, 0, sizeof(var->value));
+
+    var->type = (VarType)value.type;
+    var->is_declared = true;
+    switch (value.type) {
+        case NOOBIE_INT: var->value.i_val = value.as.i_val; break;
+        case NOOBIE_FLOAT: var->value.f_val = value.as.f_val; break;
+        case NOOBIE_CHAR: var->value.c_val = value.as.c_val; break;
+        case NOOBIE_STR: {
+            const char *text = value.as.s_val ? value.as.s_val : "";
+            string_assign(ctx, &var->value.s_val, text, strlen(text));
+            break;
+        }
+        case NOOBIE_BOOL: var->value.b_val = value.as.b_val; break;
+    }
+    return NOOBIE_OK;
+}
+
+// Legge una variabile dichiarata
+int noobie_get(NoobieContext *ctx, const char *name, NoobieValue *value) {
+    clear_error(ctx);
+    const Variable *var = find_variable(ctx, name);
+    if (!var) return api_error(ctx, "VARIABLE NOT FOUND. ");
+
+    value->type = (NoobieType)var->type;
+    switch (var->type) {
+        case TYPE_INT: value->as.i_val = var->value.i_val; break;
+        case TYPE_FLOAT: value->as.f_val = var->value.f_val; break;
+        case TYPE_CHAR: value->as.c_val = var->value.c_val; break;
+        case TYPE_STR: value->as.s_val = string_data(&var->value.s_val); break;
+        case TYPE_BOOL: value->as.b_val = var->value.b_val; break;
+        default: return api_error(ctx, "UNSUPPORTED VARIABLE TYPE. ");
+    }
+    return NOOBIE_OK;
+}
+
+// -------------------------- COSTRUTTORI DEI VALORI --------------------------
+
+NoobieValue noobie_int(int64_t value) {
+    NoobieValue v = {NOOBIE_INT, {.i_val = value}};
+    return v;
+}
+
+NoobieValue noobie_float(double value) {
+    NoobieValue v = {NOOBIE_FLOAT, {.f_val = value}};
+    return v;
+}
+
+NoobieValue noobie_char(char value) {
+    NoobieValue v = {NOOBIE_CHAR, {.c_val = value}};
+    return v;
+}
+
+NoobieValue noobie_str(const char *value) {
+    NoobieValue v = {NOOBIE_STR, {.s_val = value}};
+    return v;
+}
+
+NoobieValue noobie_bool(bool value) {
+    NoobieValue v = {NOOBIE_BOOL, {.b_val = value}};
+    return v;
+}
@@ -0,0 +1,63 @@
+#ifndef LIBNOOBIE_H
+#define LIBNOOBIE_H
+
+// API C per incorporare l'interprete noobie in un altro programma.
+// Ogni contesto è indipendente: contesti diversi possono essere usati da thread diversi,
+// uno stesso contesto da un thread alla volta.
+//
+//     NoobieContext *ctx = noobie_create();
+//     noobie_set_output(ctx, my_sink, my_data);
+//     noobie_set(ctx, "x", noobie_int(41));
+//     if (noobie_eval(ctx, "INCREMENT x\nSAY \"x=@x\"\n", NOOBIE_NUL_TERMINATED) != NOOBIE_OK)
+//         fprintf(stderr, "%s", noobie_last_error(ctx));
+//     noobie_destroy(ctx);
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define NOOBIE_OK 0
+#define NOOBIE_ERROR 1
+#define NOOBIE_NUL_TERMINATED ((size_t)-1)
+
+typedef struct Interpreter NoobieContext;
+
+// Tipi dei valori scambiati con l'interprete (stesso ordine di VarType)
+typedef enum {
+    NOOBIE_INT, NOOBIE_FLOAT, NOOBIE_CHAR, NOOBIE_STR, NOOBIE_BOOL
+} NoobieType;
+
+// Valore tipizzato; per NOOBIE_STR la stringa appartiene al contesto (valida fino alla prossima chiamata)
+typedef struct {
+    NoobieType type;
+    union {
+        int64_t i_val;
+        double f_val;
+        char c_val;
+        const char *s_val;
+        bool b_val;
+    } as;
+} NoobieValue;
+
+// Riceve l'output del programma a blocchi (non terminati da '\0')
+typedef void (*NoobieSink)(void *user_data, const char *data, size_t len);
+
+// Dichiarazione delle funzioni della libreria
+NoobieContext *noobie_create(void);
+void noobie_destroy(NoobieContext *ctx);
+void noobie_set_output(NoobieContext *ctx, NoobieSink sink, void *user_data);
+void noobie_set_input(NoobieContext *ctx, const char *data, size_t len);
+int noobie_eval(NoobieContext *ctx, const char *source, size_t len);
+int noobie_calc(NoobieContext *ctx, const char *expression, NoobieValue *result);
+int noobie_set(NoobieContext *ctx, const char *name, NoobieValue value);
+int noobie_get(NoobieContext *ctx, const char *name, NoobieValue *value);
+const char *noobie_last_error(const NoobieContext *ctx);
+
+// Costruttori dei valori
+NoobieValue noobie_int(int64_t value);
+NoobieValue noobie_float(double value);
+NoobieValue noobie_char(char value);
+NoobieValue noobie_str(const char *value);
+NoobieValue noobie_bool(bool value);
+
+#endif
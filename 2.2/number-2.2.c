@@ -0,0 +1,233 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include <locale.h>
+#include <pthread.h>
+
+#include "number-2.2.h"
+
+// Conversioni tra testo e numeri senza passare da strtoll/atof/printf: una sola passata
+// valida e converte, la formattazione scrive direttamente nel buffer di destinazione.
+// Il separatore decimale è sempre '.', qualunque sia la locale del processo ospite.
+
+static const double exact_powers[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const uint64_t powers_of_ten[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull
+};
+
+#define FIXED_MAX_PRECISION 9
+#define FIXED_LIMIT 10000000000000000000ull // 10^19: oltre si passa a snprintf
+
+// -------------------------- LETTURA --------------------------
+
+// Intero con segno opzionale; NUMBER_RANGE se non sta in 64 bit
+NumberStatus parse_int(const char *text, size_t len, int64_t *out) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < len && (text[i] == '-' || text[i] == '+')) negative = text[i++] == '-';
+    if (i == len) return NUMBER_INVALID;
+
+    uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+    uint64_t value = 0;
+    bool overflow = false;
+    for (; i < len; i++) {
+        unsigned digit = (unsigned char)text[i] - '0';
+        if (digit > 9) return NUMBER_INVALID;
+        if (value > (limit - digit) / 10) overflow = true; // continua a validare le cifre rimaste
+        else value = value * 10 + digit;
+    }
+    if (overflow) return NUMBER_RANGE;
+
+    *out = negative ? (int64_t)(0 - value) : (int64_t)value;
+    return NUMBER_OK;
+}
+
+static locale_t c_locale;
+static pthread_once_t c_locale_once = PTHREAD_ONCE_INIT;
+
+static void create_c_locale(void) {
+    c_locale = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+}
+
+// Caso lento (più di 19 cifre significative o esponenti grandi): strtod nella locale C
+static double parse_float_slow(const char *text, size_t len) {
+    char small[128];
+    char *copy = len < sizeof(small) ? small : malloc(len + 1);
+    if (!copy) handle_error(NULL, "OUT OF MEMORY. ", -1);
+    memcpy(copy, text, len);
+    copy[len] = '\0';
+
+    pthread_once(&c_locale_once, create_c_locale);
+    locale_t previous = c_locale ? uselocale(c_locale) : (locale_t)0;
+    double value = strtod(copy, NULL);
+    if (c_locale) uselocale(previous);
+
+    if (copy != small) free(copy);
+    return value;
+}
+
+// [-+]cifre[.cifre][e[-+]cifre], almeno una cifra nella mantissa. Con al più 19 cifre
+// significative e un esponente piccolo il risultato è una sola operazione esatta (Clinger)
+NumberStatus parse_float(const char *text, size_t len, double *out) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < len && (text[i] == '-' || text[i] == '+')) negative = text[i++] == '-';
+
+    uint64_t mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool any_digit = false, truncated = false, in_fraction = false;
+    for (; i < len; i++) {
+        char c = text[i];
+        if (c == '.' && !in_fraction) {
+            in_fraction = true;
+            continue;
+        }
+        unsigned digit = (unsigned char)c - '0';
+        if (digit > 9) break;
+        any_digit = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + digit;
+            if (mantissa) digits++; // gli zeri iniziali non sono significativi
+            if (in_fraction) exponent--;
+        } else {
+            truncated |= digit != 0;
+            if (!in_fraction) exponent++;
+        }
+    }
+    if (!any_digit) return NUMBER_INVALID;
+
+    if (i < len && (text[i] == 'e' || text[i] == 'E')) {
+        i++;
+        bool negative_exponent = false;
+        if (i < len && (text[i] == '-' || text[i] == '+')) negative_exponent = text[i++] == '-';
+        if (i == len) return NUMBER_INVALID;
+        int value = 0;
+        for (; i < len; i++) {
+            unsigned digit = (unsigned char)text[i] - '0';
+            if (digit > 9) return NUMBER_INVALID;
+            if (value < 100000) value = value * 10 + digit;
+        }
+        exponent += negative_exponent ? -value : value;
+    }
+    if (i != len) return NUMBER_INVALID;
+
+    double value;
+    if (mantissa == 0) value = 0.0;
+    else if (!truncated && mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22)
+        value = exponent < 0 ? (double)mantissa / exact_powers[-exponent] : (double)mantissa * exact_powers[exponent];
+    else
+        value = fabs(parse_float_slow(text, len));
+
+    if (isinf(value)) return NUMBER_RANGE;
+    *out = negative ? -value : value;
+    return NUMBER_OK;
+}
+
+// -------------------------- SCRITTURA --------------------------
+
+static const char digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Cifre di un intero senza segno, due alla volta dalla tabella
+static size_t format_uint(char *out, uint64_t value) {
+    char buffer[20];
+    char *p = buffer + sizeof(buffer);
+    while (value >= 100) {
+        p -= 2;
+        memcpy(p, digit_pairs + (value % 100) * 2, 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        p -= 2;
+        memcpy(p, digit_pairs + value * 2, 2);
+    } else
+        *--p = (char)('0' + value);
+
+    size_t len = (size_t)(buffer + sizeof(buffer) - p);
+    memcpy(out, p, len);
+    return len;
+}
+
+// Come "%" PRId64; out deve avere almeno 20 caratteri liberi (nessun '\0')
+size_t format_int(char *out, int64_t value) {
+    size_t len = 0;
+    uint64_t magnitude = (uint64_t)value;
+    if (value < 0) {
+        out[len++] = '-';
+        magnitude = 0 - magnitude;
+    }
+    return len + format_uint(out + len, magnitude);
+}
+
+// Come "%.Nf" (stesso arrotondamento esatto, metà al pari), senza '\0' finale.
+// Il valore binario esatto mantissa * 2^-shift viene scalato di 10^precision in 128 bit.
+// Restituisce 0 se il valore non è finito o il risultato supera 10^19 (vedi text_append_fixed)
+size_t format_fixed(char *out, double value, int precision) {
+    if (!isfinite(value) || precision < 0 || precision > FIXED_MAX_PRECISION) return 0;
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bool negative = bits >> 63;
+    int biased = (int)((bits >> 52) & 0x7FF);
+    uint64_t mantissa = bits & ((1ull << 52) - 1);
+    if (biased) mantissa |= 1ull << 52;
+    else biased = 1; // subnormale
+    int shift = 1075 - biased; // value = mantissa * 2^-shift
+
+    unsigned __int128 scaled = (unsigned __int128)mantissa * powers_of_ten[precision]; // < 2^83
+    unsigned __int128 rounded;
+    if (shift <= 0) {
+        if (-shift > 40) return 0;
+        rounded = scaled << -shift;
+    } else if (shift >= 100) {
+        rounded = 0; // il resto è sempre sotto la metà
+    } else {
+        rounded = scaled >> shift;
+        unsigned __int128 rest = scaled & (((unsigned __int128)1 << shift) - 1);
+        unsigned __int128 half = (unsigned __int128)1 << (shift - 1);
+        if (rest > half || (rest == half && (rounded & 1))) rounded++;
+    }
+    if (rounded >= FIXED_LIMIT) return 0;
+
+    uint64_t units = (uint64_t)rounded;
+    size_t len = 0;
+    if (negative) out[len++] = '-'; // anche -0.00, come printf
+    len += format_uint(out + len, units / powers_of_ten[precision]);
+    if (precision > 0) {
+        out[len++] = '.';
+        uint64_t fraction = units % powers_of_ten[precision];
+        for (int i = precision; i > 0; i--) {
+            out[len + i - 1] = (char)('0' + fraction % 10);
+            fraction /= 10;
+        }
+        len += (size_t)precision;
+    }
+    return len;
+}
+
+void text_append_int(TextBuffer *buffer, int64_t value) {
+    text_reserve(buffer, NUMBER_TEXT_SIZE);
+    buffer->len += format_int(buffer->data + buffer->len, value);
+    buffer->data[buffer->len] = '\0';
+}
+
+// Valori enormi, inf e nan passano ancora da snprintf
+void text_append_fixed(TextBuffer *buffer, double value, int precision) {
+    text_reserve(buffer, NUMBER_TEXT_SIZE);
+    size_t len = format_fixed(buffer->data + buffer->len, value, precision);
+    if (len == 0) {
+        int needed = snprintf(NULL, 0, "%.*f", precision, value);
+        text_reserve(buffer, (size_t)needed + 1);
+        len = (size_t)snprintf(buffer->data + buffer->len, (size_t)needed + 1, "%.*f", precision, value);
+    }
+    buffer->len += len;
+    buffer->data[buffer->len] = '\0';
+}
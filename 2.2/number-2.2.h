@@ -0,0 +1,25 @@
+#ifndef NUMBER_H
+#define NUMBER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "helper_function-2.2.h"
+
+// Spazio sufficiente per un INT formattato e per un FLOAT del formato veloce
+#define NUMBER_TEXT_SIZE 48
+
+// Esito della conversione di un numero
+typedef enum {
+    NUMBER_OK, NUMBER_INVALID, NUMBER_RANGE
+} NumberStatus;
+
+// Dichiarazione delle funzioni numeriche: conversioni indipendenti dalla locale
+NumberStatus parse_int(const char *text, size_t len, int64_t *out);
+NumberStatus parse_float(const char *text, size_t len, double *out);
+size_t format_int(char *out, int64_t value);
+size_t format_fixed(char *out, double value, int precision);
+void text_append_int(TextBuffer *buffer, int64_t value);
+void text_append_fixed(TextBuffer *buffer, double value, int precision);
+
+#endif
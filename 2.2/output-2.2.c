@@ -0,0 +1,78 @@
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "output-2.2.h"
+
+// Buffer di output del contesto: viene svuotato con write(2) (o passato al sink del chiamante)
+// solo quando è pieno o ai punti di flush espliciti (prompt di LISTEN, EXIT, errori, fine del
+// programma). Con output_fd < 0 l'output resta nel buffer, dove il chiamante lo raccoglie.
+
+// Buffer su cui scrivere direttamente (es. render dei template); chiamare output_commit dopo
+TextBuffer *output_buffer(Interpreter *interp) {
+    return &interp->output;
+}
+
+// Svuota il buffer se ha superato la soglia
+void output_commit(Interpreter *interp) {
+    if (interp->output.len >= OUTPUT_BUFFER_SIZE) output_flush(interp);
+}
+
+// Accoda dati all'output
+void output_write(Interpreter *interp, const char *data, size_t len) {
+    text_append(&interp->output, data, len);
+    output_commit(interp);
+}
+
+// Scrive count caratteri del motivo ripetuto ciclicamente, a blocchi: prima una copia del motivo,
+// poi il blocco già scritto viene raddoppiato con memcpy fino a riempire lo spazio disponibile
+void output_repeat(Interpreter *interp, const char *pattern, size_t pattern_len, size_t count) {
+    TextBuffer *output = &interp->output;
+    size_t phase = 0; // posizione nel motivo da cui riprendere dopo un flush
+
+    while (count > 0) {
+        size_t chunk = count < OUTPUT_BUFFER_SIZE ? count : OUTPUT_BUFFER_SIZE;
+        text_reserve(output, chunk);
+        char *dst = output->data + output->len;
+
+        size_t filled = 0, p = phase;
+        while (filled < chunk && filled < pattern_len) {
+            dst[filled++] = pattern[p++];
+            if (p == pattern_len) p = 0;
+        }
+        while (filled < chunk) {
+            size_t copy = filled < chunk - filled ? filled : chunk - filled;
+            memcpy(dst + filled, dst, copy);
+            filled += copy;
+        }
+        phase = (phase + chunk) % pattern_len;
+
+        output->len += chunk;
+        output->data[output->len] = '\0';
+        count -= chunk;
+        output_commit(interp);
+    }
+}
+
+// Scrive tutto il contenuto del buffer sulla destinazione del contesto
+void output_flush(Interpreter *interp) {
+    TextBuffer *output = &interp->output;
+    if (interp->sink) {
+        if (output->len) interp->sink(interp->sink_data, output->data, output->len);
+        output->len = 0;
+        return;
+    }
+    if (interp->output_fd < 0) return; // output catturato
+
+    size_t done = 0;
+    while (done < output->len) {
+        ssize_t written = write(interp->output_fd, output->data + done, output->len - done);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            break; // stdout chiuso: l'output viene scartato
+        }
+        done += (size_t)written;
+    }
+    output->len = 0;
+}
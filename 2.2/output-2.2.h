@@ -0,0 +1,18 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stddef.h>
+
+#include "helper_function-2.2.h"
+
+// Soglia oltre la quale il buffer di output viene svuotato
+#define OUTPUT_BUFFER_SIZE (64 * 1024)
+
+// Dichiarazione delle funzioni di output: unico percorso di scrittura verso stdout
+TextBuffer *output_buffer(Interpreter *interp);
+void output_commit(Interpreter *interp);
+void output_write(Interpreter *interp, const char *data, size_t len);
+void output_repeat(Interpreter *interp, const char *pattern, size_t pattern_len, size_t count);
+void output_flush(Interpreter *interp);
+
+#endif
@@ -0,0 +1,165 @@
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "helper_function-2.2.h"
+#include "profiler-2.2.h"
+
+#define MAX_PROFILE_KINDS 32
+#define REPORT_TOP_LINES 30
+
+int trace_level = 0;
+bool profiling_enabled = false;
+
+// Statistiche per riga del sorgente
+typedef struct {
+    uint64_t hits;
+    uint64_t total;
+    uint64_t sections[PROFILE_SECTIONS];
+    const char *op_name;
+    int line;
+} LineProfile;
+
+// Statistiche per tipo di comando
+typedef struct {
+    uint64_t hits;
+    uint64_t total;
+    const char *op_name;
+} KindProfile;
+
+static LineProfile *lines = NULL;
+static int line_capacity = 0;
+static KindProfile kinds[MAX_PROFILE_KINDS];
+static LineProfile *current = NULL;
+static int current_kind = 0;
+static const char *folded_file = NULL;
+
+static const char *section_names[PROFILE_SECTIONS] = {"evaluate_expression", "render_template"};
+
+// Tempo monotono in nanosecondi
+uint64_t profiler_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Attiva il profiling; il report viene scritto all'uscita del programma
+void profiler_start(const char *folded_path) {
+    profiling_enabled = true;
+    folded_file = folded_path;
+    atexit(profiler_report);
+}
+
+// Inizio di un'istruzione: il conteggio avviene subito (un errore risale prima di profile_leave)
+void profile_enter(int line, int op, const char *op_name) {
+    if (line < 0) line = 0;
+    if (line >= line_capacity) {
+        int capacity = line_capacity ? line_capacity : 256;
+        while (line >= capacity) capacity *= 2;
+        LineProfile *grown = realloc(lines, capacity * sizeof(LineProfile));
+        if (!grown) handle_error(NULL, "OUT OF MEMORY. ", line);
+        memset(grown + line_capacity, 0, (capacity - line_capacity) * sizeof(LineProfile));
+        lines = grown;
+        line_capacity = capacity;
+    }
+
+    current = &lines[line];
+    current->line = line;
+    current->op_name = op_name;
+    current->hits++;
+
+    current_kind = op < MAX_PROFILE_KINDS ? op : MAX_PROFILE_KINDS - 1;
+    kinds[current_kind].op_name = op_name;
+    kinds[current_kind].hits++;
+}
+
+// Fine di un'istruzione
+void profile_leave(uint64_t elapsed) {
+    if (!current) return;
+    current->total += elapsed;
+    kinds[current_kind].total += elapsed;
+}
+
+// Tempo speso in una sezione dell'istruzione corrente
+void profile_section(ProfileSection section, uint64_t elapsed) {
+    if (current) current->sections[section] += elapsed;
+}
+
+static int compare_lines(const void *a, const void *b) {
+    const LineProfile *x = a, *y = b;
+    if (x->total != y->total) return x->total < y->total ? 1 : -1;
+    return x->line - y->line;
+}
+
+static int compare_kinds(const void *a, const void *b) {
+    const KindProfile *x = a, *y = b;
+    if (x->total != y->total) return x->total < y->total ? 1 : -1;
+    return 0;
+}
+
+// Scrive il formato "folded stacks" (una riga per stack, valore in microsecondi) per i flamegraph
+static void write_folded(const LineProfile *sorted, int count) {
+    FILE *out = fopen(folded_file, "w");
+    if (!out) {
+        fprintf(stderr, "PROFILE: COULD NOT WRITE %s\n", folded_file);
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const LineProfile *p = &sorted[i];
+        uint64_t self = p->total;
+        for (int s = 0; s < PROFILE_SECTIONS; s++) {
+            uint64_t spent = p->sections[s] < self ? p->sections[s] : self;
+            self -= spent;
+            if (spent / 1000)
+                fprintf(out, "noobie;%s:%d;%s %llu\n", p->op_name, p->line, section_names[s],
+                        (unsigned long long)(spent / 1000));
+        }
+        if (self / 1000)
+            fprintf(out, "noobie;%s:%d %llu\n", p->op_name, p->line, (unsigned long long)(self / 1000));
+    }
+    fclose(out);
+}
+
+// Report ordinato per costo su stderr, più l'eventuale file folded
+void profiler_report(void) {
+    if (!profiling_enabled) return;
+
+    int count = 0;
+    for (int i = 0; i < line_capacity; i++)
+        if (lines[i].hits) lines[count++] = lines[i];
+    qsort(lines, count, sizeof(LineProfile), compare_lines);
+
+    uint64_t grand_total = 0;
+    for (int i = 0; i < count; i++) grand_total += lines[i].total;
+
+    fprintf(stderr, "\n---------------- PROFILE ----------------\n");
+    fprintf(stderr, "%6s %-10s %12s %12s %8s %12s %12s\n",
+            "LINE", "COMMAND", "HITS", "TOTAL(ms)", "%", "EXPR(ms)", "TEMPLATE(ms)");
+    for (int i = 0; i < count && i < REPORT_TOP_LINES; i++) {
+        const LineProfile *p = &lines[i];
+        fprintf(stderr, "%6d %-10s %12llu %12.3f %7.2f%% %12.3f %12.3f\n",
+                p->line, p->op_name, (unsigned long long)p->hits, p->total / 1e6,
+                grand_total ? 100.0 * p->total / grand_total : 0.0,
+                p->sections[PROFILE_EXPRESSION] / 1e6, p->sections[PROFILE_TEMPLATE] / 1e6);
+    }
+    if (count > REPORT_TOP_LINES) fprintf(stderr, "   ... %d more lines\n", count - REPORT_TOP_LINES);
+
+    KindProfile sorted_kinds[MAX_PROFILE_KINDS];
+    memcpy(sorted_kinds, kinds, sizeof(kinds));
+    qsort(sorted_kinds, MAX_PROFILE_KINDS, sizeof(KindProfile), compare_kinds);
+
+    fprintf(stderr, "\n%-10s %12s %12s %12s\n", "COMMAND", "HITS", "TOTAL(ms)", "AVG(ns)");
+    for (int i = 0; i < MAX_PROFILE_KINDS; i++) {
+        const KindProfile *k = &sorted_kinds[i];
+        if (!k->hits) continue;
+        fprintf(stderr, "%-10s %12llu %12.3f %12llu\n", k->op_name, (unsigned long long)k->hits,
+                k->total / 1e6, (unsigned long long)(k->total / k->hits));
+    }
+
+    if (folded_file) write_folded(lines, count);
+    profiling_enabled = false;
+}
@@ -0,0 +1,43 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Livello di trace a compile-time: con -DNOOBIE_TRACE=0 ogni TRACE sparisce dal binario
+#ifndef NOOBIE_TRACE
+#define NOOBIE_TRACE 1
+#endif
+
+// Livelli di trace a runtime (--trace=N): 1 = istruzioni eseguite, 2 = token delle espressioni
+#define TRACE_EXEC 1
+#define TRACE_TOKENS 2
+
+#define TRACE(level, ...) \
+    do { if (NOOBIE_TRACE && trace_level >= (level)) fprintf(stderr, __VA_ARGS__); } while (0)
+
+// Sezioni misurate all'interno di un'istruzione
+typedef enum {
+    PROFILE_EXPRESSION,   // valutazione delle espressioni (CALC)
+    PROFILE_TEMPLATE,     // interpolazione dei messaggi (SAY, EXIT, LISTEN, LINE)
+    PROFILE_SECTIONS
+} ProfileSection;
+
+// Misura una sezione solo se il profiling è attivo
+#define PROFILE_BEGIN(var) uint64_t var = profiling_enabled ? profiler_now() : 0
+#define PROFILE_END(section, var) \
+    do { if (profiling_enabled) profile_section((section), profiler_now() - (var)); } while (0)
+
+extern int trace_level;
+extern bool profiling_enabled;
+
+// Dichiarazione delle funzioni del profiler
+uint64_t profiler_now(void);
+void profiler_start(const char *folded_path);
+void profile_enter(int line, int op, const char *op_name);
+void profile_leave(uint64_t elapsed);
+void profile_section(ProfileSection section, uint64_t elapsed);
+void profiler_report(void);
+
+#endif
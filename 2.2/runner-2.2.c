@@ -0,0 +1,246 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <sys/stat.h>
+
+#include "helper_function-2.2.h"
+#include "interpreter-2.2.h"
+#include "input-2.2.h"
+
+// -------------------------- ESECUZIONE IN BATCH --------------------------
+// Ogni script gira nel proprio contesto, con output ed errori catturati in memoria.
+// I lavori sono distribuiti su code per thread: ognuno consuma la propria dalla testa e,
+// quando è vuota, ruba dalla coda di un altro. Il thread principale stampa i risultati
+// nell'ordine degli script man mano che sono pronti.
+
+// Uno script da eseguire e il suo risultato
+typedef struct {
+    char *path;
+    int exit_code;
+    TextBuffer output;
+    TextBuffer errors;
+    bool done;
+} Job;
+
+// Coda di lavori di un thread: indici in [head, tail)
+typedef struct {
+    pthread_mutex_t lock;
+    int *items;
+    int head;
+    int tail;
+} WorkQueue;
+
+typedef struct {
+    Job *jobs;
+    WorkQueue *queues;
+    int worker_count;
+    bool use_cache;
+    bool use_jit;
+    pthread_mutex_t done_lock;
+    pthread_cond_t done_cond;
+} Batch;
+
+typedef struct {
+    Batch *batch;
+    int id;
+} Worker;
+
+// Prende il prossimo lavoro della propria coda (dalla testa)
+static int take_job(WorkQueue *queue) {
+    int job = -1;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->head < queue->tail) job = queue->items[queue->head++];
+    pthread_mutex_unlock(&queue->lock);
+    return job;
+}
+
+// Ruba l'ultimo lavoro della coda di un altro thread (il più lontano dalla stampa)
+static int steal_job(WorkQueue *queue) {
+    int job = -1;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->head < queue->tail) job = queue->items[--queue->tail];
+    pthread_mutex_unlock(&queue->lock);
+    return job;
+}
+
+// Esegue uno script in un contesto nuovo, catturandone output ed errori
+static void run_job(Job *job, bool use_cache, bool use_jit) {
+    Interpreter interp;
+    init_interpreter(&interp);
+    interp.use_cache = use_cache;
+    interp.use_jit = use_jit;
+    interp.output_fd = -1;
+    interp.error_fd = -1;
+    input_from_fd(&interp.input, -1, false); // in batch LISTEN non ha input
+
+    job->exit_code = interpret_file(&interp, job->path);
+    job->output = interp.output;
+    job->errors = interp.errors;
+    interp.output = (TextBuffer){0};
+    interp.errors = (TextBuffer){0};
+    free_interpreter(&interp);
+}
+
+static void *worker_main(void *arg) {
+    Worker *worker = arg;
+    Batch *batch = worker->batch;
+
+    for (;;) {
+        int job = take_job(&batch->queues[worker->id]);
+        for (int i = 1; job < 0 && i < batch->worker_count; i++)
+            job = steal_job(&batch->queues[(worker->id + i) % batch->worker_count]);
+        if (job < 0) break; // nessun lavoro rimasto: le code non ricevono nuovi elementi
+
+        run_job(&batch->jobs[job], batch->use_cache, batch->use_jit);
+
+        pthread_mutex_lock(&batch->done_lock);
+        batch->jobs[job].done = true;
+        pthread_cond_broadcast(&batch->done_cond);
+        pthread_mutex_unlock(&batch->done_lock);
+    }
+    return NULL;
+}
+
+// Scrive tutto il buffer sul descrittore indicato
+static void write_all(int fd, const TextBuffer *text) {
+    size_t done = 0;
+    while (done < text->len) {
+        ssize_t written = write(fd, text->data + done, text->len - done);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        done += (size_t)written;
+    }
+}
+
+// -------------------------- RACCOLTA DEGLI SCRIPT --------------------------
+
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static void add_path(char ***list, int *count, int *capacity, char *path) {
+    if (*count == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 64;
+        *list = realloc(*list, *capacity * sizeof(char *));
+        if (!*list) handle_error(NULL, "OUT OF MEMORY. ", -1);
+    }
+    (*list)[(*count)++] = path;
+}
+
+// Espande le cartelle nei loro file .nob (in ordine alfabetico); i file restano come sono
+static char **collect_scripts(char **paths, int path_count, int *script_count) {
+    char **scripts = NULL;
+    int count = 0, capacity = 0;
+
+    for (int i = 0; i < path_count; i++) {
+        struct stat info;
+        if (stat(paths[i], &info) != 0 || !S_ISDIR(info.st_mode)) {
+            add_path(&scripts, &count, &capacity, strdup(paths[i]));
+            continue;
+        }
+
+        DIR *dir = opendir(paths[i]);
+        if (!dir) handle_error(NULL, "COULD NOT OPEN DIRECTORY. ", -1);
+        int first = count;
+        struct dirent *entry;
+        while ((entry = readdir(dir))) {
+            size_t len = strlen(entry->d_name);
+            if (len < 4 || strcmp(entry->d_name + len - 4, ".nob") != 0) continue;
+
+            char *path = malloc(strlen(paths[i]) + len + 2);
+            if (!path) handle_error(NULL, "OUT OF MEMORY. ", -1);
+            sprintf(path, "%s/%s", paths[i], entry->d_name);
+            add_path(&scripts, &count, &capacity, path);
+        }
+        closedir(dir);
+        qsort(scripts + first, count - first, sizeof(char *), compare_paths);
+    }
+
+    *script_count = count;
+    return scripts;
+}
+
+/// ----------------- RUNNER -----------------
+// Esegue tutti gli script con jobs thread; restituisce 0 se nessuno è fallito
+int run_batch(char **paths, int path_count, int jobs, bool use_cache, bool use_jit) {
+    int count;
+    char **scripts = collect_scripts(paths, path_count, &count);
+    if (count == 0) {
+        free(scripts);
+        return 0;
+    }
+    if (jobs < 1) jobs = 1;
+    if (jobs > count) jobs = count;
+
+    Batch batch;
+    batch.jobs = calloc(count, sizeof(Job));
+    batch.queues = calloc(jobs, sizeof(WorkQueue));
+    Worker *workers = calloc(jobs, sizeof(Worker));
+    pthread_t *threads = calloc(jobs, sizeof(pthread_t));
+    if (!batch.jobs || !batch.queues || !workers || !threads) handle_error(NULL, "OUT OF MEMORY. ", -1);
+    batch.worker_count = jobs;
+    batch.use_cache = use_cache;
+    batch.use_jit = use_jit;
+    pthread_mutex_init(&batch.done_lock, NULL);
+    pthread_cond_init(&batch.done_cond, NULL);
+
+    // Distribuzione a turno: ogni thread parte dagli script che verranno stampati per primi
+    for (int w = 0; w < jobs; w++) {
+        WorkQueue *queue = &batch.queues[w];
+        pthread_mutex_init(&queue->lock, NULL);
+        queue->items = malloc((count / jobs + 1) * sizeof(int));
+        if (!queue->items) handle_error(NULL, "OUT OF MEMORY. ", -1);
+    }
+    for (int i = 0; i < count; i++) {
+        batch.jobs[i].path = scripts[i];
+        WorkQueue *queue = &batch.queues[i % jobs];
+        queue->items[queue->tail++] = i;
+    }
+
+    for (int w = 0; w < jobs; w++) {
+        workers[w].batch = &batch;
+        workers[w].id = w;
+        if (pthread_create(&threads[w], NULL, worker_main, &workers[w]) != 0)
+            handle_error(NULL, "COULD NOT START WORKER THREAD. ", -1);
+    }
+
+    // Risultati in ordine: si attende il prossimo script anche se quelli dopo sono già pronti
+    int failed = 0;
+    for (int i = 0; i < count; i++) {
+        Job *job = &batch.jobs[i];
+        pthread_mutex_lock(&batch.done_lock);
+        while (!job->done) pthread_cond_wait(&batch.done_cond, &batch.done_lock);
+        pthread_mutex_unlock(&batch.done_lock);
+
+        write_all(STDOUT_FILENO, &job->output);
+        write_all(STDERR_FILENO, &job->errors);
+        if (job->exit_code != 0) failed++;
+
+        free(job->output.data);
+        free(job->errors.data);
+        free(job->path);
+    }
+
+    for (int w = 0; w < jobs; w++) pthread_join(threads[w], NULL);
+    for (int w = 0; w < jobs; w++) {
+        pthread_mutex_destroy(&batch.queues[w].lock);
+        free(batch.queues[w].items);
+    }
+    pthread_mutex_destroy(&batch.done_lock);
+    pthread_cond_destroy(&batch.done_cond);
+
+    fprintf(stderr, "BATCH: %d SCRIPTS, %d FAILED\n", count, failed);
+    free(threads);
+    free(workers);
+    free(batch.queues);
+    free(batch.jobs);
+    free(scripts);
+    return failed ? EXIT_FAILURE : 0;
+}
@@ -0,0 +1,158 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "helper_function-2.2.h"
+#include "scan-2.2.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SCAN_SIMD 1
+#else
+#define SCAN_SIMD 0
+#endif
+
+// Classificatore delle righe: un solo passaggio sul testo confronta 16 o 32 byte alla volta
+// con i caratteri speciali e produce la lista delle loro posizioni. Commenti, "--" e
+// virgolette vengono poi risolti guardando solo la lista, senza riscandire la riga.
+
+// Kernel: scrive in out le posizioni trovate (out ha spazio per len elementi), ne restituisce il numero
+typedef struct ScanKernel {
+    const char *name;
+    size_t (*scan)(const char *line, size_t len, uint32_t *out);
+} ScanKernel;
+
+// ---------- Scalare ----------
+
+static const bool is_mark[256] = {['\n'] = true, ['<'] = true, ['>'] = true, ['-'] = true, ['"'] = true};
+
+static size_t scan_scalar(const char *line, size_t len, uint32_t *out) {
+    size_t count = 0;
+    for (size_t i = 0; i < len; i++)
+        if (is_mark[(unsigned char)line[i]]) out[count++] = (uint32_t)i;
+    return count;
+}
+
+static const ScanKernel scalar_kernel = {"scalar", scan_scalar};
+
+#if SCAN_SIMD
+
+// Trasforma la maschera di un blocco in posizioni, dal bit meno significativo
+#define EMIT_BITS(bits, base)                                        \
+    while (bits) {                                                   \
+        out[count++] = (uint32_t)((base) + __builtin_ctz(bits));     \
+        bits &= bits - 1;                                            \
+    }
+
+// ---------- SSE2 (16 byte per blocco) ----------
+
+__attribute__((target("sse2")))
+static inline unsigned marks_sse2(__m128i v) {
+    __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('<'))),
+                                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('>')),
+                                             _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('-')), _mm_cmpeq_epi8(v, _mm_set1_epi8('"')))));
+    return (unsigned)_mm_movemask_epi8(hits);
+}
+
+__attribute__((target("sse2")))
+static size_t scan_sse2(const char *line, size_t len, uint32_t *out) {
+    size_t count = 0, i = 0;
+    for (; i + 16 <= len; i += 16) {
+        unsigned bits = marks_sse2(_mm_loadu_si128((const __m128i *)(line + i)));
+        EMIT_BITS(bits, i);
+    }
+
+    // Coda: un ultimo blocco copiato e completato con zeri (le righe corte stanno tutte qui)
+    if (i < len) {
+        char block[16] = {0};
+        memcpy(block, line + i, len - i);
+        unsigned bits = marks_sse2(_mm_loadu_si128((const __m128i *)block));
+        EMIT_BITS(bits, i);
+    }
+    return count;
+}
+
+static const ScanKernel sse2_kernel = {"sse2", scan_sse2};
+
+// ---------- AVX2 (32 byte per blocco) ----------
+
+__attribute__((target("avx2")))
+static inline unsigned marks_avx2(__m256i v) {
+    __m256i hits = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('<'))),
+                                   _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('>')),
+                                                   _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('-')),
+                                                                   _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')))));
+    return (unsigned)_mm256_movemask_epi8(hits);
+}
+
+__attribute__((target("avx2")))
+static size_t scan_avx2(const char *line, size_t len, uint32_t *out) {
+    size_t count = 0, i = 0;
+    for (; i + 32 <= len; i += 32) {
+        unsigned bits = marks_avx2(_mm256_loadu_si256((const __m256i *)(line + i)));
+        EMIT_BITS(bits, i);
+    }
+
+    if (i < len) {
+        char block[32] = {0};
+        memcpy(block, line + i, len - i);
+        unsigned bits = marks_avx2(_mm256_loadu_si256((const __m256i *)block));
+        EMIT_BITS(bits, i);
+    }
+    return count;
+}
+
+static const ScanKernel avx2_kernel = {"avx2", scan_avx2};
+
+#endif
+
+// ---------- Scelta a runtime ----------
+
+static const ScanKernel *active_kernel = &scalar_kernel;
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+// Come per gli array: la migliore versione supportata, NOOBIE_SIMD=scalar|sse2|avx2 la limita
+static void select_kernel(void) {
+#if SCAN_SIMD
+    const char *forced = getenv("NOOBIE_SIMD");
+    if (forced && strcmp(forced, "scalar") == 0) return;
+
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && !(forced && strcmp(forced, "sse2") == 0))
+        active_kernel = &avx2_kernel;
+    else if (__builtin_cpu_supports("sse2"))
+        active_kernel = &sse2_kernel;
+#endif
+}
+
+static const ScanKernel *get_kernel(void) {
+    pthread_once(&kernel_once, select_kernel);
+    return active_kernel;
+}
+
+// Nome del kernel in uso (benchmark)
+const char *get_scan_kernel_name(void) {
+    return get_kernel()->name;
+}
+
+// -------------------------- CLASSIFICAZIONE --------------------------
+
+// Trova in un solo passaggio tutti i caratteri speciali della riga
+void scan_line(const char *line, size_t len, LineMarks *marks) {
+    if (len > UINT32_MAX) handle_error(NULL, "LINE TOO LONG. ", -1);
+    if (len > marks->cap) {
+        size_t cap = marks->cap ? marks->cap : 256;
+        while (cap < len) cap *= 2;
+        uint32_t *pos = realloc(marks->pos, cap * sizeof(uint32_t));
+        if (!pos) handle_error(NULL, "OUT OF MEMORY. ", -1);
+        marks->pos = pos;
+        marks->cap = cap;
+    }
+    marks->count = get_kernel()->scan(line, len, marks->pos);
+}
+
+void free_line_marks(LineMarks *marks) {
+    free(marks->pos);
+    memset(marks, 0, sizeof(*marks));
+}
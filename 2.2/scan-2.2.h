@@ -0,0 +1,20 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Posizioni dei caratteri che il front end cerca in una riga ('\n', '<', '>', '-', '"'),
+// in ordine crescente. Il buffer viene riusato da una riga all'altra
+typedef struct LineMarks {
+    uint32_t *pos;
+    size_t count;
+    size_t cap;
+} LineMarks;
+
+// Dichiarazione delle funzioni del classificatore
+void scan_line(const char *line, size_t len, LineMarks *marks);
+void free_line_marks(LineMarks *marks);
+const char *get_scan_kernel_name(void);
+
+#endif
@@ -0,0 +1,84 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "string-2.2.h"
+
+// -------------------------- ARENA --------------------------
+// Le stringhe lunghe vengono ritagliate da blocchi grandi e non vengono mai liberate
+// una per una: tutta l'arena se ne va con free_interpreter.
+
+typedef struct StringChunk {
+    struct StringChunk *next;
+    size_t used;
+    size_t size;
+    char data[];
+} StringChunk;
+
+// Ritaglia size byte dal blocco corrente, aprendone uno nuovo se non c'è spazio
+static char *arena_alloc(Interpreter *interp, size_t size) {
+    size = (size + 7) & ~(size_t)7;
+
+    StringChunk *chunk = interp->strings;
+    if (!chunk || chunk->size - chunk->used < size) {
+        size_t chunk_size = size > STRING_CHUNK_SIZE ? size : STRING_CHUNK_SIZE;
+        chunk = malloc(sizeof(StringChunk) + chunk_size);
+        if (!chunk) handle_error(NULL, "OUT OF MEMORY. ", -1);
+        chunk->used = 0;
+        chunk->size = chunk_size;
+
+        // Un blocco fuori misura va dietro a quello corrente, che può ancora servire
+        if (interp->strings && chunk_size > STRING_CHUNK_SIZE) {
+            chunk->next = interp->strings->next;
+            interp->strings->next = chunk;
+        } else {
+            chunk->next = interp->strings;
+            interp->strings = chunk;
+        }
+    }
+
+    char *block = chunk->data + chunk->used;
+    chunk->used += size;
+    return block;
+}
+
+// Libera tutti i blocchi dell'arena
+void free_string_arena(Interpreter *interp) {
+    StringChunk *chunk = interp->strings;
+    while (chunk) {
+        StringChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    interp->strings = NULL;
+}
+
+// -------------------------- STRINGHE --------------------------
+
+// Copia text in str riusando la capacità già assegnata; il testo può sovrapporsi a str.
+// Una stringa passata nell'arena ci resta: un buffer più piccolo non viene mai restituito
+void string_assign(Interpreter *interp, String *str, const char *text, size_t len) {
+    if (len > STRING_MAX_LENGTH) handle_error(interp, "STRING TOO LONG. ", -1);
+
+    char *dest;
+    if (str->cap == 0 && len <= STRING_INLINE_CAPACITY) {
+        dest = str->data.inline_text;
+    } else if (len < str->cap) {
+        dest = str->data.ptr;
+    } else {
+        // Crescita geometrica: riassegnazioni sempre più lunghe non riempiono l'arena
+        size_t cap = (size_t)str->cap * 2 > len + 1 ? (size_t)str->cap * 2 : len + 1;
+        if (cap < 32) cap = 32;
+        if (cap > STRING_MAX_LENGTH + 1) cap = STRING_MAX_LENGTH + 1;
+        dest = arena_alloc(interp, cap);
+        memcpy(dest, text, len); // il vecchio buffer resta valido: text può puntarci
+        str->data.ptr = dest;
+        str->cap = (uint32_t)cap;
+        dest[len] = '\0';
+        str->len = (uint32_t)len;
+        return;
+    }
+
+    memmove(dest, text, len);
+    dest[len] = '\0';
+    str->len = (uint32_t)len;
+}
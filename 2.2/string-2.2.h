@@ -0,0 +1,24 @@
+#ifndef STRING_H
+#define STRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "helper_function-2.2.h"
+
+// Dimensione minima di un blocco dell'arena delle stringhe
+#define STRING_CHUNK_SIZE 65536
+
+// Lunghezza massima di una stringa
+#define STRING_MAX_LENGTH ((size_t)UINT32_MAX - 1)
+
+// Testo della stringa, terminato da '\0'
+static inline const char *string_data(const String *str) {
+    return str->cap ? str->data.ptr : str->data.inline_text;
+}
+
+// Dichiarazione delle funzioni delle stringhe
+void string_assign(Interpreter *interp, String *str, const char *text, size_t len);
+void free_string_arena(Interpreter *interp);
+
+#endif
@@ -0,0 +1,204 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <inttypes.h>
+
+#include "bytecode-2.2.h"
+#include "array-2.2.h"
+#include "string-2.2.h"
+#include "number-2.2.h"
+#include "profiler-2.2.h"
+
+// -------------------------- COMPILAZIONE DEI TEMPLATE --------------------------
+
+// Accoda un segmento al programma
+static Segment *add_segment(Program *program, SegmentKind kind, int slot, uint32_t text, uint32_t len) {
+    if (program->segment_count == program->segment_cap) {
+        size_t cap = program->segment_cap ? program->segment_cap * 2 : 64;
+        Segment *segments = realloc(program->segments, cap * sizeof(Segment));
+        if (!segments) handle_error(NULL, "OUT OF MEMORY. ", -1);
+        program->segments = segments;
+        program->segment_cap = cap;
+    }
+
+    Segment *seg = &program->segments[program->segment_count++];
+    seg->kind = kind;
+    seg->slot = slot;
+    seg->index = -1;
+    seg->text = text;
+    seg->len = len;
+    return seg;
+}
+
+// Indice di @nome[i]: un numero o il nome di una variabile INT; false (e p invariato) se non è un indice
+static bool parse_index(Interpreter *interp, const char **p, int *slot, uint32_t *literal) {
+    const char *q = *p + 1;
+    const char *start = q;
+    if (isdigit((unsigned char)*q)) {
+        uint64_t value = 0;
+        while (isdigit((unsigned char)*q) && value <= UINT32_MAX) value = value * 10 + (uint64_t)(*q++ - '0');
+        if (*q != ']' || value > UINT32_MAX) return false;
+        *slot = -1;
+        *literal = (uint32_t)value;
+    } else {
+        while (*q && (isalnum((unsigned char)*q) || *q == '_') && q - start < MAX_VAR_NAME - 1) q++;
+        if (q == start || *q != ']') return false;
+        *slot = intern_variable_len(interp, start, q - start);
+        *literal = 0;
+    }
+    *p = q + 1;
+    return true;
+}
+
+// Carattere prodotto da una sequenza di escape (stessa tabella di escape_special_chars)
+static char resolve_escape(char c) {
+    switch (c) {
+        case 'n': return '\n';
+        case 't': return '\t';
+        case 'r': return '\t';
+        case 'b': return '\t';
+        default: return c; // @, #, ", \ e qualsiasi altro carattere restano letterali
+    }
+}
+
+// Chiude il segmento letterale in costruzione, se non vuoto
+static void flush_literal(Program *program, TextBuffer *literal) {
+    if (literal->len == 0) return;
+    add_segment(program, SEG_TEXT, -1, add_string(program, literal->data, literal->len), (uint32_t)literal->len);
+    literal->len = 0;
+}
+
+// Traduce un messaggio in segmenti: testo con escape risolti e riferimenti @nome/#nome legati a uno slot
+void compile_template(Interpreter *interp, Program *program, const char *text, uint32_t *first, uint32_t *count) {
+    TextBuffer literal = {0};
+    *first = (uint32_t)program->segment_count;
+
+    for (const char *p = text; *p; ) {
+        if (*p == '\\') {
+            p++;
+            if (*p == '\0') break; // backslash finale: ignorato
+            char c = resolve_escape(*p++);
+            text_append(&literal, &c, 1);
+        } else if (*p == '@' || *p == '#') {
+            SegmentKind kind = *p++ == '@' ? SEG_VALUE : SEG_TYPE;
+            const char *name = p;
+            while (*p && (isalnum((unsigned char)*p) || *p == '_') && p - name < MAX_VAR_NAME - 1) p++;
+
+            flush_literal(program, &literal);
+            int slot = intern_variable_len(interp, name, p - name);
+            int index;
+            uint32_t position;
+            const char *bracket = p;
+            if (kind == SEG_VALUE && *p == '[' && parse_index(interp, &p, &index, &position)) {
+                // il testo "[...]" resta nel pool: se a runtime la variabile non è un array va stampato così com'è
+                uint32_t source = add_string(program, bracket, p - bracket);
+                add_segment(program, SEG_ELEMENT, slot, source, position)->index = index;
+            } else
+                add_segment(program, kind, slot, 0, 0);
+        } else {
+            const char *start = p;
+            while (*p && *p != '\\' && *p != '@' && *p != '#') p++;
+            text_append(&literal, start, p - start);
+        }
+    }
+
+    flush_literal(program, &literal);
+    free(literal.data);
+    *count = (uint32_t)(program->segment_count - *first);
+}
+
+// -------------------------- RENDERING --------------------------
+
+// Accoda il valore formattato di una variabile
+static void append_value(TextBuffer *out, const Variable *var) {
+    char temp[64];
+    int len;
+
+    switch (var->type) {
+        case TYPE_INT: text_append_int(out, var->value.i_val); return;
+        case TYPE_FLOAT: text_append_fixed(out, var->value.f_val, 2); return;
+        case TYPE_CHAR:
+            if (var->value.c_val) text_append(out, &var->value.c_val, 1);
+            return;
+        case TYPE_STR: text_append(out, string_data(&var->value.s_val), var->value.s_val.len); return;
+        case TYPE_BOOL: len = snprintf(temp, sizeof(temp), "%s", var->value.b_val ? "true" : "false"); break;
+        case TYPE_ARRAY_INT:
+        case TYPE_ARRAY_FLOAT: append_array(out, var->value.a_val, -1); return;
+        default: len = snprintf(temp, sizeof(temp), "[unknown]"); break;
+    }
+    if (len >= (int)sizeof(temp)) len = sizeof(temp) - 1;
+    text_append(out, temp, len);
+}
+
+// Accoda l'elemento @nome[i]; indice non valido -> [undefined], variabile non array -> valore seguito da "[i]"
+static void append_element(Interpreter *interp, const Program *program, TextBuffer *out, const Variable *var, const Segment *seg) {
+    if (!is_array_type(var->type)) {
+        const char *bracket = get_string(program, seg->text);
+        append_value(out, var);
+        text_append(out, bracket, strlen(bracket));
+        return;
+    }
+
+    int64_t index = seg->len;
+    if (seg->index >= 0) {
+        const Variable *position = &interp->stack[seg->index];
+        index = position->is_declared && position->type == TYPE_INT ? position->value.i_val : -1;
+    }
+    if (index < 0) text_append(out, "[undefined]", 11);
+    else append_array(out, var->value.a_val, index);
+}
+
+// Accoda al buffer il messaggio con i valori correnti delle variabili
+void render_template(Interpreter *interp, const Program *program, uint32_t first, uint32_t count, TextBuffer *out) {
+    PROFILE_BEGIN(started);
+    for (uint32_t i = first; i < first + count; i++) {
+        const Segment *seg = &program->segments[i];
+
+        if (seg->kind == SEG_TEXT) {
+            text_append(out, get_string(program, seg->text), seg->len);
+            continue;
+        }
+
+        const Variable *var = &interp->stack[seg->slot];
+        if (!var->is_declared) {
+            text_append(out, "[undefined]", 11);
+            if (seg->kind == SEG_ELEMENT) {
+                const char *bracket = get_string(program, seg->text);
+                text_append(out, bracket, strlen(bracket));
+            }
+        } else if (seg->kind == SEG_VALUE) {
+            append_value(out, var);
+        } else if (seg->kind == SEG_ELEMENT) {
+            append_element(interp, program, out, var, seg);
+        } else {
+            const char *type = get_string_from_type(var->type);
+            text_append(out, type, strlen(type));
+        }
+    }
+    PROFILE_END(PROFILE_TEMPLATE, started);
+}
+
+// -------------------------- ARGOMENTI DI LINE --------------------------
+
+// Estrae da "<count> [symbol]" il numero di ripetizioni e il motivo (NULL oppure il messaggio d'errore)
+const char *parse_line_arguments(char *text, int *count, const char **symbol) {
+    char *p = text;
+    while (*p == ' ') p++;
+    if (*p == '\0') return "LINE REQUIRES AT LEAST ONE PARAMETER. ";
+
+    char *first = p;
+    while (*p && *p != ' ') p++;
+    *symbol = *p ? p + 1 : "";
+    if (*p) *p = '\0';
+
+    int64_t value;
+    if (*first == '-' || parse_int(first, strlen(first), &value) != NUMBER_OK || value > INT_MAX)
+        return "INVALID INTEGER VALUE FOR LINE. ";
+    *count = (int)value;
+
+    if (**symbol == '\0') *symbol = "-";
+    return NULL;
+}
@@ -0,0 +1,814 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <math.h>
+
+#include "transpile-2.2.h"
+
+// Traduzione ahead-of-time (--emit-c): il programma già compilato diventa un sorgente C con
+// un main, da collegare a libnoobie.a. Ogni istruzione è tradotta in ordine e i salti di
+// IF/WHILE/REPEAT diventano goto verso etichette, quindi il flusso resta quello della VM.
+// Le espressioni diventano assegnamenti a temporanei nell'ordine del codice RPN (gli errori
+// arrivano nello stesso ordine dell'interprete) e le variabili dichiarate sempre con lo stesso
+// tipo numerico vengono lette e scritte direttamente, senza passare dal tipo a runtime.
+// SAY e LINE statici scrivono letterali già pronti; LISTEN, gli array e i valori di tipo non
+// noto in compilazione usano le stesse funzioni della VM, così messaggi e formati coincidono.
+
+#define LINE_LITERAL_MAX 4096 // LINE statici fino a questa lunghezza diventano un letterale
+
+typedef struct {
+    FILE *out;
+    const Program *program;
+    VarType *types;     // tipo statico di ogni slot, TYPE_UNKNOW = noto solo a runtime
+    bool *seen;         // slot dichiarato da almeno un'istruzione
+    int temps;          // temporanei usati finora
+} Transpiler;
+
+// Valore intermedio di un'espressione: t<id>, di tipo C fisso oppure CalcResult (TYPE_UNKNOW)
+typedef struct {
+    VarType type;
+    int id;
+} Temp;
+
+static const char *opcode_enum_names[] = {
+    "OP_CLEAR", "OP_EXIT", "OP_LINE", "OP_CALC", "OP_SET", "OP_SAY", "OP_LISTEN", "OP_INCREMENT", "OP_DECREMENT",
+    "OP_ERROR", "OP_ARRAY", "OP_FILL", "OP_MAP", "OP_SUM", "OP_MIN", "OP_MAX", "OP_MEAN", "OP_DOT", "OP_BRANCH",
+    "OP_JUMP", "OP_WHILE", "OP_REPEAT", "OP_NEXT"
+};
+
+static const char *operator_enum_names[] = {
+    "OPERATOR_NONE", "OPERATOR_ADD", "OPERATOR_SUB", "OPERATOR_MUL", "OPERATOR_DIV", "OPERATOR_MOD",
+    "OPERATOR_POW", "OPERATOR_SAFE_POW", "OPERATOR_EQ", "OPERATOR_NE", "OPERATOR_LT", "OPERATOR_GT",
+    "OPERATOR_LE", "OPERATOR_GE", "OPERATOR_AND", "OPERATOR_OR", "OPERATOR_XOR", "OPERATOR_NOT"
+};
+
+static const char *segment_enum_names[] = {"SEG_TEXT", "SEG_VALUE", "SEG_TYPE", "SEG_ELEMENT"};
+
+static const char *expr_enum_names[] = {"EXPR_CONSTANT", "EXPR_VARIABLE", "EXPR_UNARY", "EXPR_BINARY"};
+
+static const char *type_enum_names[] = {
+    "TYPE_INT", "TYPE_FLOAT", "TYPE_CHAR", "TYPE_STR", "TYPE_BOOL", "TYPE_ARRAY_INT", "TYPE_ARRAY_FLOAT", "TYPE_UNKNOW"
+};
+
+// Funzioni di supporto del programma generato; l'aritmetica controllata (calc_*) e INCREMENT/DECREMENT
+// (step_variable) vengono da calc_parser.h e dalla VM, come nell'interprete
+static const char *prelude =
+    "// Termina con un errore: handle_error risale al main con longjmp e non ritorna\n"
+    "static void nb_fail(Interpreter *interp, const char *message, int line) __attribute__((noreturn, cold));\n"
+    "static void nb_fail(Interpreter *interp, const char *message, int line) {\n"
+    "    handle_error(interp, message, line);\n"
+    "    abort();\n"
+    "}\n"
+    "\n"
+    "static inline CalcResult nb_int(int64_t value) {\n"
+    "    CalcResult result = {TYPE_INT, {.i_val = value}};\n"
+    "    return result;\n"
+    "}\n"
+    "\n"
+    "static inline CalcResult nb_float(double value) {\n"
+    "    CalcResult result = {TYPE_FLOAT, {.f_val = value}};\n"
+    "    return result;\n"
+    "}\n"
+    "\n"
+    "static inline CalcResult nb_bool(bool value) {\n"
+    "    CalcResult result = {TYPE_BOOL, {.b_val = value}};\n"
+    "    return result;\n"
+    "}\n"
+    "\n"
+    "static inline bool nb_true(CalcResult value) {\n"
+    "    switch (value.type) {\n"
+    "        case TYPE_BOOL: return value.value.b_val;\n"
+    "        case TYPE_INT: return value.value.i_val != 0;\n"
+    "        case TYPE_FLOAT: return value.value.f_val != 0.0;\n"
+    "        default: return false;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "static inline void nb_print(Interpreter *interp, CalcResult result, int line) {\n"
+    "    TextBuffer *out = output_buffer(interp);\n"
+    "    switch (result.type) {\n"
+    "        case TYPE_INT: text_append_int(out, result.value.i_val); break;\n"
+    "        case TYPE_FLOAT: text_append_fixed(out, result.value.f_val, 6); break;\n"
+    "        case TYPE_BOOL:\n"
+    "            if (result.value.b_val) text_append(out, \"true\", 4);\n"
+    "            else text_append(out, \"false\", 5);\n"
+    "            break;\n"
+    "        default: nb_fail(interp, \"UNSUPPORTED RESULT TYPE FROM CALC. \", line);\n"
+    "    }\n"
+    "    output_write(interp, \"\\n\", 1);\n"
+    "}\n"
+    "\n"
+    "static inline int64_t nb_repeat_count(Interpreter *interp, CalcResult count, int line) {\n"
+    "    if (count.type != TYPE_INT || count.value.i_val < 0)\n"
+    "        nb_fail(interp, \"REPEAT COUNT MUST BE A NON-NEGATIVE INTEGER. \", line);\n"
+    "    return count.value.i_val;\n"
+    "}\n";
+
+// Main del programma generato: stesse opzioni di LISTEN dell'interprete, stesso codice d'uscita
+static const char *epilogue =
+    "int main(int argc, char *argv[]) {\n"
+    "    Interpreter interp;\n"
+    "    init_interpreter(&interp);\n"
+    "    for (int i = 1; i < argc; i++) {\n"
+    "        if (strcmp(argv[i], \"--input\") == 0 && i + 1 < argc) {\n"
+    "            if (!input_open_file(&interp.input, argv[++i])) handle_error(NULL, \"COULD NOT OPEN INPUT FILE. \", -1);\n"
+    "        } else if (strcmp(argv[i], \"--record\") == 0 && i + 1 < argc) {\n"
+    "            if (!input_record(&interp.input, argv[++i])) handle_error(NULL, \"COULD NOT OPEN RECORD FILE. \", -1);\n"
+    "        } else if (strcmp(argv[i], \"--quiet-prompts\") == 0)\n"
+    "            interp.quiet_prompts = true;\n"
+    "        else\n"
+    "            handle_error(NULL, \"USAGE: [--input FILE] [--record FILE] [--quiet-prompts] \", -1);\n"
+    "    }\n"
+    "    for (int i = 0; names[i]; i++) intern_variable(&interp, names[i]); // stessi slot del compilatore\n"
+    "\n"
+    "    jmp_buf on_error;\n"
+    "    interp.on_error = &on_error;\n"
+    "    if (setjmp(on_error) == 0) run(&interp);\n"
+    "    interp.on_error = NULL;\n"
+    "\n"
+    "    output_flush(&interp);\n"
+    "    int status = interp.exit_code;\n"
+    "    free_interpreter(&interp);\n"
+    "    return status;\n"
+    "}\n";
+
+// -------------------------- LETTERALI --------------------------
+
+// Letterale stringa C: gli ottali hanno sempre tre cifre, così il carattere dopo non li allunga
+static void emit_string(FILE *out, const char *text, size_t len) {
+    fputc('"', out);
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+        else if (c == '\n') fputs("\\n", out);
+        else if (c == '\t') fputs("\\t", out);
+        else if (c == '?') fputs("\\?", out); // niente trigrafi
+        else if (c >= 0x20 && c < 0x7F) fputc(c, out);
+        else fprintf(out, "\\%03o", c);
+    }
+    fputc('"', out);
+}
+
+static void emit_int(FILE *out, int64_t value) {
+    if (value == INT64_MIN) fputs("INT64_MIN", out);
+    else fprintf(out, "INT64_C(%" PRId64 ")", value);
+}
+
+// Double esatto (esadecimale), infiniti e NaN compresi
+static void emit_double(FILE *out, double value) {
+    if (isnan(value)) fputs("NAN", out);
+    else if (isinf(value)) fputs(value > 0 ? "HUGE_VAL" : "-HUGE_VAL", out);
+    else fprintf(out, "%a", value);
+}
+
+static void emit_fail(Transpiler *t, const char *message, int line) {
+    fputs("        nb_fail(interp, ", t->out);
+    emit_string(t->out, message, strlen(message));
+    fprintf(t->out, ", %d);\n", line);
+}
+
+// -------------------------- TIPI STATICI --------------------------
+
+static bool is_scalar(VarType type) {
+    return type == TYPE_INT || type == TYPE_FLOAT || type == TYPE_BOOL;
+}
+
+static void merge_type(Transpiler *t, int slot, VarType type) {
+    if (slot < 0) return;
+    if (!t->seen[slot]) t->types[slot] = type;
+    else if (t->types[slot] != type) t->types[slot] = TYPE_UNKNOW;
+    t->seen[slot] = true;
+}
+
+// Una variabile ha un tipo statico se tutte le istruzioni che possono dichiararla usano lo stesso:
+// SET e LISTEN lo indicano, le riduzioni lo scelgono a runtime
+static void infer_types(Transpiler *t, int slot_count) {
+    for (int i = 0; i < slot_count; i++) t->types[i] = TYPE_UNKNOW;
+    for (size_t pc = 0; pc < t->program->count; pc++) {
+        const Instruction *in = &t->program->code[pc];
+        switch (in->op) {
+            case OP_SET:
+            case OP_LISTEN:
+            case OP_ARRAY:
+                merge_type(t, in->slot, in->type);
+                break;
+            case OP_SUM:
+            case OP_MIN:
+            case OP_MAX:
+            case OP_MEAN:
+            case OP_DOT:
+                merge_type(t, in->target, TYPE_UNKNOW);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// -------------------------- ESPRESSIONI --------------------------
+
+static Temp new_temp(Transpiler *t, VarType type) {
+    static const char *c_types[] = {[TYPE_INT] = "int64_t", [TYPE_FLOAT] = "double", [TYPE_BOOL] = "bool", [TYPE_UNKNOW] = "CalcResult"};
+    Temp temp = {type, t->temps++};
+    fprintf(t->out, "        %s t%d = ", c_types[type], temp.id);
+    return temp;
+}
+
+// Operando convertito: 'i' intero (BOOL vale 0/1), 'd' double, 'b' valore di verità, 'r' CalcResult
+static void emit_operand(Transpiler *t, Temp temp, char as) {
+    FILE *out = t->out;
+    switch (as) {
+        case 'i':
+            fprintf(out, temp.type == TYPE_BOOL ? "(int64_t)t%d" : "t%d", temp.id);
+            break;
+        case 'd':
+            fprintf(out, temp.type == TYPE_FLOAT ? "t%d" : "(double)t%d", temp.id);
+            break;
+        case 'b':
+            if (temp.type == TYPE_INT) fprintf(out, "(t%d != 0)", temp.id);
+            else if (temp.type == TYPE_FLOAT) fprintf(out, "(t%d != 0.0)", temp.id);
+            else if (temp.type == TYPE_BOOL) fprintf(out, "t%d", temp.id);
+            else fprintf(out, "nb_true(t%d)", temp.id);
+            break;
+        default:
+            if (temp.type == TYPE_INT) fprintf(out, "nb_int(t%d)", temp.id);
+            else if (temp.type == TYPE_FLOAT) fprintf(out, "nb_float(t%d)", temp.id);
+            else if (temp.type == TYPE_BOOL) fprintf(out, "nb_bool(t%d)", temp.id);
+            else fprintf(out, "t%d", temp.id);
+            break;
+    }
+}
+
+// Dopo un errore certo il valore non viene mai usato, ma il codice deve comunque compilare
+static Temp emit_unreachable(Transpiler *t, const char *message, int line) {
+    emit_fail(t, message, line);
+    Temp temp = new_temp(t, TYPE_INT);
+    fputs("0;\n", t->out);
+    return temp;
+}
+
+// Operatore con almeno un operando di tipo dinamico: stesso percorso dell'interprete
+static Temp emit_generic_binary(Transpiler *t, OperatorKind op, Temp l, Temp r, int line, VarType type) {
+    Temp temp = new_temp(t, type);
+    fprintf(t->out, "apply_binary_operator(interp, %s, ", operator_enum_names[op]);
+    emit_operand(t, l, 'r');
+    fputs(", ", t->out);
+    emit_operand(t, r, 'r');
+    fprintf(t->out, ", %d)%s;\n", line, type == TYPE_FLOAT ? ".value.f_val" : "");
+    return temp;
+}
+
+static Temp emit_binary(Transpiler *t, OperatorKind op, Temp l, Temp r, int line) {
+    if (l.type == TYPE_UNKNOW || r.type == TYPE_UNKNOW || op == OPERATOR_NONE || op >= OPERATOR_NOT)
+        return emit_generic_binary(t, op, l, r, line, TYPE_UNKNOW);
+
+    FILE *out = t->out;
+    bool is_float = l.type == TYPE_FLOAT || r.type == TYPE_FLOAT;
+    char as = is_float ? 'd' : 'i';
+    Temp temp;
+    switch (op) {
+        case OPERATOR_ADD:
+        case OPERATOR_SUB:
+        case OPERATOR_MUL:
+            if (is_float) {
+                static const char symbols[] = {[OPERATOR_ADD] = '+', [OPERATOR_SUB] = '-', [OPERATOR_MUL] = '*'};
+                temp = new_temp(t, TYPE_FLOAT);
+                emit_operand(t, l, 'd');
+                fprintf(out, " %c ", symbols[op]);
+                emit_operand(t, r, 'd');
+                fputs(";\n", out);
+                return temp;
+            }
+            temp = new_temp(t, TYPE_INT);
+            fprintf(out, "%s(interp, ", op == OPERATOR_ADD ? "calc_add_int" : op == OPERATOR_SUB ? "calc_sub_int" : "calc_mul_int");
+            break;
+
+        case OPERATOR_DIV:
+            temp = new_temp(t, TYPE_FLOAT);
+            fputs(is_float ? "calc_div_float(interp, " : "calc_div_int(interp, ", out);
+            break;
+
+        case OPERATOR_MOD:
+            if (l.type != TYPE_INT || r.type != TYPE_INT) {
+                fprintf(out, "        (void)t%d;\n        (void)t%d;\n", l.id, r.id);
+                return emit_unreachable(t, "MODULO OPERATOR REQUIRES INTEGER OPERANDS", line);
+            }
+            temp = new_temp(t, TYPE_INT);
+            fputs("calc_mod_int(interp, ", out);
+            break;
+
+        case OPERATOR_POW:
+        case OPERATOR_SAFE_POW:
+            // tra interi il tipo dipende dal segno dell'esponente
+            return emit_generic_binary(t, op, l, r, line, is_float ? TYPE_FLOAT : TYPE_UNKNOW);
+
+        case OPERATOR_AND:
+        case OPERATOR_OR:
+        case OPERATOR_XOR:
+            temp = new_temp(t, TYPE_BOOL);
+            emit_operand(t, l, 'b');
+            fputs(op == OPERATOR_AND ? " && " : op == OPERATOR_OR ? " || " : " != ", out);
+            emit_operand(t, r, 'b');
+            fputs(";\n", out);
+            return temp;
+
+        default: { // confronti
+            static const char *symbols[] = {[OPERATOR_EQ] = "==", [OPERATOR_NE] = "!=", [OPERATOR_LT] = "<",
+                                            [OPERATOR_GT] = ">", [OPERATOR_LE] = "<=", [OPERATOR_GE] = ">="};
+            temp = new_temp(t, TYPE_BOOL);
+            emit_operand(t, l, as);
+            fprintf(out, " %s ", symbols[op]);
+            emit_operand(t, r, as);
+            fputs(";\n", out);
+            return temp;
+        }
+    }
+
+    emit_operand(t, l, as);
+    fputs(", ", out);
+    emit_operand(t, r, as);
+    fprintf(out, ", %d);\n", line);
+    return temp;
+}
+
+static Temp emit_unary(Transpiler *t, OperatorKind op, Temp operand, int line) {
+    FILE *out = t->out;
+    Temp temp;
+    if (operand.type == TYPE_UNKNOW || (op != OPERATOR_SUB && op != OPERATOR_ADD && op != OPERATOR_NOT)) {
+        temp = new_temp(t, TYPE_UNKNOW);
+        fprintf(out, "apply_unary_operator(interp, %s, ", operator_enum_names[op]);
+        emit_operand(t, operand, 'r');
+        fprintf(out, ", %d);\n", line);
+        return temp;
+    }
+
+    if (operand.type == TYPE_BOOL && op != OPERATOR_NOT) fprintf(out, "        (void)t%d;\n", operand.id);
+    switch (op) {
+        case OPERATOR_SUB:
+            if (operand.type == TYPE_BOOL) return emit_unreachable(t, "UNARY MINUS REQUIRES NUMERIC OPERAND", line);
+            temp = new_temp(t, operand.type);
+            if (operand.type == TYPE_INT) fprintf(out, "calc_neg_int(interp, t%d, %d);\n", operand.id, line);
+            else fprintf(out, "-t%d;\n", operand.id);
+            return temp;
+        case OPERATOR_ADD:
+            if (operand.type == TYPE_BOOL) return emit_unreachable(t, "UNARY PLUS REQUIRES NUMERIC OPERAND", line);
+            return operand;
+        default:
+            temp = new_temp(t, TYPE_BOOL);
+            fputc('!', out);
+            emit_operand(t, operand, 'b');
+            fputs(";\n", out);
+            return temp;
+    }
+}
+
+// Traduce il codice RPN di un'istruzione in una sequenza di temporanei; restituisce il risultato
+static Temp emit_expression(Transpiler *t, const Instruction *in) {
+    const ExprOp *ops = t->program->exprs.ops + in->expr;
+    Temp *stack = malloc((in->expr_len + 1) * sizeof(Temp));
+    if (!stack) handle_error(NULL, "OUT OF MEMORY. ", -1);
+    int sp = 0;
+
+    for (uint32_t i = 0; i < in->expr_len; i++) {
+        const ExprOp *op = &ops[i];
+        switch (op->type) {
+            case EXPR_CONSTANT:
+                stack[sp] = new_temp(t, op->value.type);
+                if (op->value.type == TYPE_INT) emit_int(t->out, op->value.value.i_val);
+                else if (op->value.type == TYPE_FLOAT) emit_double(t->out, op->value.value.f_val);
+                else fputs(op->value.value.b_val ? "true" : "false", t->out);
+                fputs(";\n", t->out);
+                sp++;
+                break;
+            case EXPR_VARIABLE: {
+                VarType type = t->types[op->slot];
+                if (is_scalar(type)) {
+                    static const char *fields[] = {[TYPE_INT] = "i_val", [TYPE_FLOAT] = "f_val", [TYPE_BOOL] = "b_val"};
+                    fprintf(t->out, "        if (!v[%d].is_declared) nb_fail(interp, \"VARIABLE NOT FOUND IN EXPRESSION\", %d);\n",
+                            op->slot, in->line);
+                    stack[sp] = new_temp(t, type);
+                    fprintf(t->out, "v[%d].value.%s;\n", op->slot, fields[type]);
+                } else {
+                    stack[sp] = new_temp(t, TYPE_UNKNOW);
+                    fprintf(t->out, "load_variable(interp, %d, %d);\n", op->slot, in->line);
+                }
+                sp++;
+                break;
+            }
+            case EXPR_UNARY:
+                stack[sp - 1] = emit_unary(t, op->op, stack[sp - 1], in->line);
+                break;
+            case EXPR_BINARY:
+                sp--;
+                stack[sp - 1] = emit_binary(t, op->op, stack[sp - 1], stack[sp], in->line);
+                break;
+        }
+    }
+
+    Temp result = stack[0];
+    free(stack);
+    return result;
+}
+
+// -------------------------- ISTRUZIONI --------------------------
+
+// Template inline: testo letterale e variabili di tipo statico; il resto passa da render_template
+static void emit_template(Transpiler *t, uint32_t first, uint32_t count) {
+    const Program *program = t->program;
+    FILE *out = t->out;
+    for (uint32_t i = first; i < first + count; i++) {
+        const Segment *seg = &program->segments[i];
+        if (seg->kind == SEG_TEXT) {
+            fputs("        text_append(out, ", out);
+            emit_string(out, get_string(program, seg->text), seg->len);
+            fprintf(out, ", %" PRIu32 ");\n", seg->len);
+            continue;
+        }
+
+        VarType type = t->types[seg->slot];
+        if (seg->kind == SEG_TYPE && type != TYPE_UNKNOW) {
+            fprintf(out, "        text_append(out, v[%d].is_declared ? \"%s\" : \"[undefined]\", v[%d].is_declared ? %zu : 11);\n",
+                    seg->slot, get_string_from_type(type), seg->slot, strlen(get_string_from_type(type)));
+        } else if (seg->kind == SEG_VALUE && is_scalar(type)) {
+            fprintf(out, "        if (!v[%d].is_declared) text_append(out, \"[undefined]\", 11);\n", seg->slot);
+            if (type == TYPE_INT) fprintf(out, "        else text_append_int(out, v[%d].value.i_val);\n", seg->slot);
+            else if (type == TYPE_FLOAT) fprintf(out, "        else text_append_fixed(out, v[%d].value.f_val, 2);\n", seg->slot);
+            else fprintf(out, "        else if (v[%d].value.b_val) text_append(out, \"true\", 4);\n"
+                              "        else text_append(out, \"false\", 5);\n", seg->slot);
+        } else
+            fprintf(out, "        render_template(interp, &program, %" PRIu32 ", 1, out);\n", i);
+    }
+}
+
+// true se il template è fatto solo di testo letterale
+static bool template_is_literal(const Program *program, uint32_t first, uint32_t count) {
+    for (uint32_t i = first; i < first + count; i++)
+        if (program->segments[i].kind != SEG_TEXT) return false;
+    return true;
+}
+
+static void emit_literal_template(Transpiler *t, uint32_t first, uint32_t count, const char *suffix) {
+    TextBuffer text = {0};
+    text_append(&text, "", 0);
+    for (uint32_t i = first; i < first + count; i++)
+        text_append(&text, get_string(t->program, t->program->segments[i].text), t->program->segments[i].len);
+    text_append(&text, suffix, strlen(suffix));
+    fputs("        output_write(interp, ", t->out);
+    emit_string(t->out, text.data, text.len);
+    fprintf(t->out, ", %zu);\n", text.len);
+    free(text.data);
+}
+
+static void emit_say(Transpiler *t, const Instruction *in) {
+    if (template_is_literal(t->program, in->tpl, in->tpl_len)) {
+        emit_literal_template(t, in->tpl, in->tpl_len, "");
+        return;
+    }
+    fputs("        TextBuffer *out = output_buffer(interp);\n", t->out);
+    emit_template(t, in->tpl, in->tpl_len);
+    fputs("        output_commit(interp);\n", t->out);
+}
+
+static void emit_exit(Transpiler *t, const Instruction *in) {
+    if (in->tpl == NO_TEXT)
+        fputs("        output_write(interp, \"Exiting program... Goodbye!\\n\", 28);\n", t->out);
+    else if (template_is_literal(t->program, in->tpl, in->tpl_len))
+        emit_literal_template(t, in->tpl, in->tpl_len, "\n");
+    else {
+        fputs("        TextBuffer *out = output_buffer(interp);\n", t->out);
+        emit_template(t, in->tpl, in->tpl_len);
+        fputs("        output_write(interp, \"\\n\", 1);\n", t->out);
+    }
+    fputs("        output_flush(interp);\n        return;\n", t->out);
+}
+
+// LINE con argomenti statici: la riga intera è un letterale (output_repeat se è molto lunga)
+static void emit_line(Transpiler *t, const Instruction *in) {
+    const char *symbol = get_string(t->program, in->text);
+    size_t len = strlen(symbol);
+    size_t count = (size_t)in->imm.i_val;
+
+    if (count > LINE_LITERAL_MAX) {
+        fputs("        output_repeat(interp, ", t->out);
+        emit_string(t->out, symbol, len);
+        fprintf(t->out, ", %zu, %zu);\n", len, count);
+        fputs("        output_write(interp, \"\\n\", 1);\n", t->out);
+        return;
+    }
+
+    char *text = malloc(count + 2);
+    if (!text) handle_error(NULL, "OUT OF MEMORY. ", -1);
+    for (size_t i = 0; i < count; i++) text[i] = symbol[i % len];
+    text[count] = '\n';
+    fputs("        output_write(interp, ", t->out);
+    emit_string(t->out, text, count + 1);
+    fprintf(t->out, ", %zu);\n", count + 1);
+    free(text);
+}
+
+static void emit_set(Transpiler *t, const Instruction *in) {
+    FILE *out = t->out;
+    fprintf(out, "        Variable *var = declare_variable(interp, %d, %s, %s, %d);\n", in->slot,
+            type_enum_names[in->type], in->is_const ? "true" : "false", in->line);
+    switch (in->type) {
+        case TYPE_INT:
+            fputs("        var->value.i_val = ", out);
+            emit_int(out, in->imm.i_val);
+            fputs(";\n", out);
+            break;
+        case TYPE_FLOAT:
+            fputs("        var->value.f_val = ", out);
+            emit_double(out, in->imm.f_val);
+            fputs(";\n", out);
+            break;
+        case TYPE_BOOL:
+            fprintf(out, "        var->value.b_val = %s;\n", in->imm.b_val ? "true" : "false");
+            break;
+        case TYPE_CHAR:
+            fprintf(out, "        var->value.c_val = (char)%d;\n", in->imm.c_val);
+            break;
+        default: // TYPE_STR
+            fputs("        string_assign(interp, &var->value.s_val, ", out);
+            emit_string(out, get_string(t->program, in->text), in->imm.s_val.len);
+            fprintf(out, ", %" PRIu32 ");\n", in->imm.s_val.len);
+            break;
+    }
+}
+
+static void emit_step(Transpiler *t, const Instruction *in) {
+    int delta = in->op == OP_INCREMENT ? 1 : -1;
+    VarType type = t->types[in->slot];
+    if (type != TYPE_INT && type != TYPE_FLOAT) {
+        fprintf(t->out, "        step_variable(interp, %d, %d, %d);\n", in->slot, delta, in->line);
+        return;
+    }
+
+    // Tipo noto: solo l'aggiornamento in linea, gli errori (variabile non dichiarata) restano a step_variable
+    fprintf(t->out, "        if (!v[%d].is_declared) step_variable(interp, %d, %d, %d);\n", in->slot, in->slot, delta, in->line);
+    if (type == TYPE_FLOAT)
+        fprintf(t->out, "        else v[%d].value.f_val += %d;\n", in->slot, delta);
+    else
+        fprintf(t->out, "        else v[%d].value.i_val = calc_add_int(interp, v[%d].value.i_val, %d, %d);\n",
+                in->slot, in->slot, delta, in->line);
+}
+
+static void emit_calc(Transpiler *t, const Instruction *in) {
+    Temp result = emit_expression(t, in);
+    FILE *out = t->out;
+    switch (result.type) {
+        case TYPE_INT:
+            fprintf(out, "        text_append_int(output_buffer(interp), t%d);\n", result.id);
+            fputs("        output_write(interp, \"\\n\", 1);\n", out);
+            break;
+        case TYPE_FLOAT:
+            fprintf(out, "        text_append_fixed(output_buffer(interp), t%d, 6);\n", result.id);
+            fputs("        output_write(interp, \"\\n\", 1);\n", out);
+            break;
+        case TYPE_BOOL:
+            fprintf(out, "        output_write(interp, t%d ? \"true\\n\" : \"false\\n\", t%d ? 5 : 6);\n", result.id, result.id);
+            break;
+        default:
+            fprintf(out, "        nb_print(interp, t%d, %d);\n", result.id, in->line);
+            break;
+    }
+}
+
+static void emit_repeat(Transpiler *t, const Instruction *in) {
+    Temp count = emit_expression(t, in);
+    FILE *out = t->out;
+    if (count.type == TYPE_INT) {
+        fprintf(out, "        if (t%d < 0) nb_fail(interp, \"REPEAT COUNT MUST BE A NON-NEGATIVE INTEGER. \", %d);\n", count.id, in->line);
+        fprintf(out, "        v[%d].value.i_val = t%d;\n", in->slot, count.id);
+    } else if (count.type == TYPE_UNKNOW) {
+        fprintf(out, "        v[%d].value.i_val = nb_repeat_count(interp, t%d, %d);\n", in->slot, count.id, in->line);
+    } else {
+        emit_fail(t, "REPEAT COUNT MUST BE A NON-NEGATIVE INTEGER. ", in->line);
+        return;
+    }
+    fprintf(out, "        if (v[%d].value.i_val == 0) goto L%" PRIu32 ";\n", in->slot, in->jump);
+}
+
+// Istruzioni eseguite dalle funzioni della VM: I/O di LISTEN, kernel degli array, LINE dinamico
+static bool is_delegated(const Program *program, const Instruction *in) {
+    switch (in->op) {
+        case OP_LISTEN:
+        case OP_ARRAY:
+        case OP_FILL:
+        case OP_MAP:
+        case OP_SUM:
+        case OP_MIN:
+        case OP_MAX:
+        case OP_MEAN:
+        case OP_DOT:
+            return true;
+        case OP_LINE:
+            return in->text == NO_TEXT || *get_string(program, in->text) == '\0' || in->imm.i_val < 0;
+        case OP_SET:
+            return in->type != TYPE_INT && in->type != TYPE_FLOAT && in->type != TYPE_BOOL &&
+                   in->type != TYPE_CHAR && in->type != TYPE_STR;
+        default:
+            return false;
+    }
+}
+
+// -------------------------- DATI DEL PROGRAMMA --------------------------
+
+// Pool, segmenti ed espressioni servono alle istruzioni lasciate alla VM e ai segmenti non inline
+static void emit_data(Transpiler *t, Interpreter *interp, const size_t *delegated, size_t delegated_count) {
+    const Program *program = t->program;
+    FILE *out = t->out;
+
+    fputs("static const char *const names[] = {\n", out);
+    for (int i = 0; i < interp->n; i++) {
+        fputs("    ", out);
+        emit_string(out, interp->stack[i].name, strlen(interp->stack[i].name));
+        fputs(",\n", out);
+    }
+    fputs("    NULL\n};\n\n", out);
+
+    fputs("static char pool[] =\n    ", out);
+    for (size_t i = 0; i < program->pool_len; i += 64) {
+        size_t len = program->pool_len - i < 64 ? program->pool_len - i : 64;
+        emit_string(out, program->pool + i, len);
+        fputs("\n    ", out);
+    }
+    fputs("\"\";\n\n", out);
+
+    fputs("static Segment segments[] = {\n", out);
+    for (size_t i = 0; i < program->segment_count; i++) {
+        const Segment *seg = &program->segments[i];
+        fprintf(out, "    {%s, %d, %d, %" PRIu32 ", %" PRIu32 "},\n", segment_enum_names[seg->kind], seg->slot, seg->index,
+                seg->text, seg->len);
+    }
+    fputs("    {0}\n};\n\n", out);
+
+    fputs("static ExprOp ops[] = {\n", out);
+    for (size_t i = 0; i < program->exprs.count; i++) {
+        const ExprOp *op = &program->exprs.ops[i];
+        fprintf(out, "    {%s, %s, %d, {%s, {", expr_enum_names[op->type], operator_enum_names[op->op], op->slot,
+                type_enum_names[op->value.type]);
+        if (op->value.type == TYPE_FLOAT) {
+            fputs(".f_val = ", out);
+            emit_double(out, op->value.value.f_val);
+        } else if (op->value.type == TYPE_BOOL)
+            fprintf(out, ".b_val = %s", op->value.value.b_val ? "true" : "false");
+        else {
+            fputs(".i_val = ", out);
+            emit_int(out, op->value.value.i_val);
+        }
+        fputs("}}},\n", out);
+    }
+    fputs("    {0}\n};\n\n", out);
+
+    fprintf(out, "static const Program program __attribute__((unused)) = {\n"
+                 "    .pool = pool,\n    .pool_len = sizeof(pool) - 1,\n"
+                 "    .exprs = {ops, %zu, %zu},\n"
+                 "    .segments = segments,\n    .segment_count = %zu,\n};\n\n",
+            program->exprs.count, program->exprs.count, program->segment_count);
+
+    fputs("static const Instruction code[] __attribute__((unused)) = {\n", out);
+    for (size_t i = 0; i < delegated_count; i++) {
+        const Instruction *in = &program->code[delegated[i]];
+        fprintf(out, "    {.op = %s, .line = %d, .slot = %d, .operand = %d, .target = %d, .type = %s, .is_const = %s,\n"
+                     "     .text = %" PRIu32 "u, .expr = %" PRIu32 "u, .expr_len = %" PRIu32 "u, .tpl = %" PRIu32 "u, .tpl_len = %" PRIu32 "u},\n",
+                opcode_enum_names[in->op], in->line, in->slot, in->operand, in->target, type_enum_names[in->type],
+                in->is_const ? "true" : "false", in->text, in->expr, in->expr_len, in->tpl, in->tpl_len);
+    }
+    fputs("    {0}\n};\n\n", out);
+}
+
+// -------------------------- PROGRAMMA --------------------------
+
+static void emit_instruction(Transpiler *t, const Instruction *in, size_t delegated_index) {
+    FILE *out = t->out;
+    if (is_delegated(t->program, in)) {
+        fprintf(out, "        execute_single(interp, &program, &code[%zu]);\n", delegated_index);
+        return;
+    }
+
+    switch (in->op) {
+        case OP_CLEAR:
+            fputs("        output_write(interp, \"\\033[H\\033[J\", 6);\n", out);
+            break;
+        case OP_EXIT:
+            emit_exit(t, in);
+            break;
+        case OP_LINE:
+            emit_line(t, in);
+            break;
+        case OP_CALC:
+            emit_calc(t, in);
+            break;
+        case OP_SET:
+            emit_set(t, in);
+            break;
+        case OP_SAY:
+            emit_say(t, in);
+            break;
+        case OP_INCREMENT:
+        case OP_DECREMENT:
+            emit_step(t, in);
+            break;
+        case OP_ERROR:
+            emit_fail(t, get_string(t->program, in->text), in->line);
+            break;
+        case OP_BRANCH:
+        case OP_WHILE: {
+            Temp condition = emit_expression(t, in);
+            fputs("        if (!", out);
+            emit_operand(t, condition, 'b');
+            fprintf(out, ") goto L%" PRIu32 ";\n", in->jump);
+            break;
+        }
+        case OP_JUMP:
+            fprintf(out, "        goto L%" PRIu32 ";\n", in->jump);
+            break;
+        case OP_REPEAT:
+            emit_repeat(t, in);
+            break;
+        case OP_NEXT:
+            if (in->slot < 0) fprintf(out, "        goto L%" PRIu32 ";\n", in->jump);
+            else fprintf(out, "        if (--v[%d].value.i_val > 0) goto L%" PRIu32 ";\n", in->slot, in->jump);
+            break;
+        default:
+            break;
+    }
+}
+
+// Scrive il sorgente C equivalente al programma compilato nel contesto interp
+void emit_c_program(Interpreter *interp, const Program *program, const char *script, FILE *out) {
+    Transpiler t = {out, program, NULL, NULL, 0};
+    size_t slots = interp->n > 0 ? (size_t)interp->n : 1;
+    t.types = calloc(slots, sizeof(VarType));
+    t.seen = calloc(slots, sizeof(bool));
+    bool *targets = calloc(program->count + 1, sizeof(bool));
+    size_t *delegated = calloc(program->count + 1, sizeof(size_t));
+    if (!t.types || !t.seen || !targets || !delegated) handle_error(NULL, "OUT OF MEMORY. ", -1);
+    infer_types(&t, interp->n);
+
+    size_t delegated_count = 0;
+    for (size_t pc = 0; pc < program->count; pc++) {
+        const Instruction *in = &program->code[pc];
+        if (in->op == OP_BRANCH || in->op == OP_WHILE || in->op == OP_JUMP || in->op == OP_REPEAT || in->op == OP_NEXT)
+            targets[in->jump] = true;
+        if (is_delegated(program, in)) delegated[delegated_count++] = pc;
+    }
+
+    fputs("// Generato da noobie --emit-c a partire da ", out);
+    for (const char *p = script; *p; p++) fputc(*p == '\n' ? ' ' : *p, out);
+    fputs(": non modificare.\n"
+          "// Compilazione, nella cartella 2.2 dopo sh build_libnoobie.sh:\n"
+          "//     cc -O2 -I. -I.. programma.c libnoobie.a -lm -pthread -o programma\n"
+          "// Opzioni del programma: --input FILE, --record FILE, --quiet-prompts (come l'interprete).\n\n"
+          "#include <math.h>\n#include <setjmp.h>\n#include <stdint.h>\n#include <stdlib.h>\n#include <string.h>\n\n"
+          "#include \"helper_function-2.2.h\"\n#include \"calc_parser.h\"\n#include \"bytecode-2.2.h\"\n"
+          "#include \"output-2.2.h\"\n#include \"string-2.2.h\"\n#include \"number-2.2.h\"\n#include \"input-2.2.h\"\n\n", out);
+    fputs(prelude, out);
+    fputc('\n', out);
+    emit_data(&t, interp, delegated, delegated_count);
+
+    fputs("static void run(Interpreter *interp) {\n    Variable *const v = interp->stack; // gli slot non cambiano più dopo il main\n    (void)v;\n", out);
+    size_t next_delegated = 0;
+    for (size_t pc = 0; pc < program->count; pc++) {
+        const Instruction *in = &program->code[pc];
+        if (targets[pc]) fprintf(out, "L%zu:;\n", pc);
+        fprintf(out, "    { // riga %d: %s\n", in->line, get_opcode_name(in->op));
+        emit_instruction(&t, in, is_delegated(program, in) ? next_delegated++ : 0);
+        fputs("    }\n", out);
+    }
+    if (targets[program->count]) fprintf(out, "L%zu:;\n", program->count);
+    fputs("}\n\n", out);
+    fputs(epilogue, out);
+
+    free(t.types);
+    free(t.seen);
+    free(targets);
+    free(delegated);
+}
+
+// Compila lo script ("-" = stdin) e ne scrive la traduzione in C in output_path ("-" = stdout)
+int transpile_file(Interpreter *interp, const char *script, const char *output_path) {
+    bool from_stdin = strcmp(script, "-") == 0;
+    FILE *source = from_stdin ? stdin : fopen(script, "r");
+    if (!source) handle_error(NULL, "COULD NOT OPEN FILE. ", -1);
+
+    Program program;
+    init_program(&program);
+    compile_file(interp, source, &program); // gli errori di compilazione restano istruzioni ERROR
+    if (!from_stdin) fclose(source);
+
+    bool to_stdout = strcmp(output_path, "-") == 0;
+    FILE *out = to_stdout ? stdout : fopen(output_path, "w");
+    if (!out) handle_error(NULL, "COULD NOT OPEN OUTPUT FILE. ", -1);
+    emit_c_program(interp, &program, script, out);
+    bool failed = ferror(out) != 0;
+    if (to_stdout) failed |= fflush(out) != 0;
+    else failed |= fclose(out) != 0;
+
+    free_program(&program);
+    if (failed) handle_error(NULL, "COULD NOT WRITE OUTPUT FILE. ", -1);
+    return 0;
+}
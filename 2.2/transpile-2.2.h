@@ -0,0 +1,13 @@
+#ifndef TRANSPILE_H
+#define TRANSPILE_H
+
+#include <stdio.h>
+
+#include "helper_function-2.2.h"
+#include "bytecode-2.2.h"
+
+// Dichiarazione delle funzioni del traduttore in C (--emit-c)
+void emit_c_program(Interpreter *interp, const Program *program, const char *script, FILE *out);
+int transpile_file(Interpreter *interp, const char *script, const char *output_path);
+
+#endif
@@ -0,0 +1,459 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+#include "bytecode-2.2.h"
+#include "output-2.2.h"
+#include "array-2.2.h"
+#include "string-2.2.h"
+#include "input-2.2.h"
+#include "number-2.2.h"
+#include "profiler-2.2.h"
+#include "jit-2.2.h"
+
+// Dispatch del ciclo principale: con GCC/Clang ogni handler salta direttamente al successivo
+// (computed goto); -DNOOBIE_SWITCH_DISPATCH, o un altro compilatore, usa lo switch portabile
+#if defined(__GNUC__) && !defined(NOOBIE_SWITCH_DISPATCH)
+#define VM_THREADED 1
+#else
+#define VM_THREADED 0
+#endif
+
+// -------------------------- ESECUZIONE DELLE ISTRUZIONI --------------------------
+
+// Produce il testo di un template nel buffer dei messaggi del contesto
+static const char *render_message(Interpreter *interp, const Program *program, const Instruction *in) {
+    TextBuffer *message = &interp->message;
+    message->len = 0;
+    text_append(message, "", 0);
+    render_template(interp, program, in->tpl, in->tpl_len, message);
+    return message->data;
+}
+
+static void run_line(Interpreter *interp, const Program *program, const Instruction *in) {
+    int count = in->imm.i_val;
+    const char *symbol;
+
+    if (in->text != NO_TEXT) {
+        symbol = get_string(program, in->text); // risolto in compilazione
+    } else {
+        render_message(interp, program, in);
+        const char *error = parse_line_arguments(interp->message.data, &count, &symbol);
+        if (error) handle_error(interp, error, in->line);
+    }
+
+    output_repeat(interp, symbol, strlen(symbol), count);
+    output_write(interp, "\n", 1);
+}
+
+// Stampa un risultato di CALC (o di una riduzione) in base al tipo
+static void print_result(Interpreter *interp, CalcResult result, int line) {
+    TextBuffer *out = output_buffer(interp);
+    switch (result.type) {
+        case TYPE_INT:
+            text_append_int(out, result.value.i_val);
+            break;
+        case TYPE_FLOAT:
+            text_append_fixed(out, result.value.f_val, 6);
+            break;
+        case TYPE_BOOL:
+            if (result.value.b_val) text_append(out, "true", 4);
+            else text_append(out, "false", 5);
+            break;
+        default:
+            handle_error(interp, "UNSUPPORTED RESULT TYPE FROM CALC. ", line);
+    }
+    text_append(out, "\n", 1);
+    output_commit(interp);
+}
+
+// Valuta l'espressione dell'istruzione; con --jit passa dal codice nativo quando è calda
+static inline CalcResult evaluate(Interpreter *interp, const Program *program, const Instruction *in) {
+    if (program->jit) return jit_evaluate(interp, program->jit, &program->exprs, in->expr, in->expr_len, in->line);
+    return evaluate_compiled(interp, program->exprs.ops + in->expr, in->expr_len, in->line);
+}
+
+static void run_calc(Interpreter *interp, const Program *program, const Instruction *in) {
+    // Valuta l'espressione già compilata, senza espandere né rianalizzare il testo
+    print_result(interp, evaluate(interp, program, in), in->line);
+}
+
+// Condizione di IF: un BOOL, oppure un numero diverso da zero
+static bool is_true(CalcResult result) {
+    switch (result.type) {
+        case TYPE_BOOL: return result.value.b_val;
+        case TYPE_INT: return result.value.i_val != 0;
+        case TYPE_FLOAT: return result.value.f_val != 0.0;
+        default: return false;
+    }
+}
+
+// REPEAT: il numero di giri è valutato una sola volta, all'ingresso nel ciclo
+static void run_repeat(Interpreter *interp, const Program *program, const Instruction *in, size_t *pc) {
+    CalcResult count = evaluate(interp, program, in);
+    if (count.type != TYPE_INT || count.value.i_val < 0)
+        handle_error(interp, "REPEAT COUNT MUST BE A NON-NEGATIVE INTEGER. ", in->line);
+    interp->stack[in->slot].value.i_val = count.value.i_val;
+    if (count.value.i_val == 0) *pc = in->jump;
+}
+
+// -------------------------- ARRAY --------------------------
+
+static Array *get_array(Interpreter *interp, int slot, int line) {
+    Variable *var = &interp->stack[slot];
+    if (!var->is_declared) handle_error(interp, "VARIABLE NOT FOUND. ", line);
+    if (!is_array_type(var->type)) handle_error(interp, "VARIABLE IS NOT AN ARRAY. ", line);
+    return var->value.a_val;
+}
+
+static void run_array(Interpreter *interp, const Program *program, const Instruction *in) {
+    CalcResult size = evaluate(interp, program, in);
+    if (size.type != TYPE_INT || size.value.i_val <= 0 || (uint64_t)size.value.i_val > ARRAY_MAX_LENGTH)
+        handle_error(interp, "INVALID ARRAY SIZE. ", in->line);
+    if (interp->stack[in->slot].is_declared) handle_error(interp, "VARIABLE ALREADY DECLARED. ", in->line);
+
+    Array *array = new_array(in->type == TYPE_ARRAY_INT ? TYPE_INT : TYPE_FLOAT, (size_t)size.value.i_val);
+    if (!array) handle_error(interp, "OUT OF MEMORY. ", in->line);
+    declare_variable(interp, in->slot, in->type, false, in->line)->value.a_val = array;
+}
+
+static void run_bulk(Interpreter *interp, const Program *program, const Instruction *in) {
+    Array *array = get_array(interp, in->slot, in->line);
+    const ExprOp *ops = program->exprs.ops + in->expr;
+    TRACE(TRACE_EXEC, "TRACE: LINE %d %s KERNELS %s\n", in->line, get_opcode_name(in->op), get_array_kernels_name());
+
+    if (in->op == OP_FILL) fill_array(interp, array, evaluate(interp, program, in), in->line);
+    else map_array(interp, array, ops, in->expr_len, in->line);
+}
+
+// Il risultato va nella variabile indicata (dichiarata se serve) oppure viene stampato
+static void run_reduce(Interpreter *interp, const Instruction *in) {
+    const Array *array = get_array(interp, in->slot, in->line);
+    CalcResult result;
+    switch (in->op) {
+        case OP_SUM: result = reduce_array(interp, array, REDUCE_SUM, in->line); break;
+        case OP_MIN: result = reduce_array(interp, array, REDUCE_MIN, in->line); break;
+        case OP_MAX: result = reduce_array(interp, array, REDUCE_MAX, in->line); break;
+        case OP_MEAN: result = reduce_array(interp, array, REDUCE_MEAN, in->line); break;
+        default: result = dot_arrays(interp, array, get_array(interp, in->operand, in->line), in->line); break;
+    }
+
+    if (in->target < 0) {
+        print_result(interp, result, in->line);
+        return;
+    }
+
+    Variable *var = &interp->stack[in->target];
+    if (!var->is_declared) declare_variable(interp, in->target, result.type, false, in->line);
+    else if (var->is_const) handle_error(interp, "CAN NOT MODIFY A CONSTANT VARIABLE. ", in->line);
+    else if (var->type != result.type) handle_error(interp, "RESULT TYPE DOES NOT MATCH VARIABLE TYPE. ", in->line);
+
+    if (result.type == TYPE_INT) var->value.i_val = result.value.i_val;
+    else var->value.f_val = result.value.f_val;
+}
+
+static void run_listen(Interpreter *interp, const Program *program, const Instruction *in) {
+    // Espansione del prompt: solo un terminale ha bisogno del flush prima della lettura,
+    // da file o pipe il prompt resta nel buffer insieme al resto dell'output
+    if (!interp->quiet_prompts) {
+        render_template(interp, program, in->tpl, in->tpl_len, output_buffer(interp));
+        if (input_is_interactive(&interp->input)) output_flush(interp);
+        else output_commit(interp);
+    }
+
+    const char *line;
+    size_t len;
+    if (!input_read_line(&interp->input, &line, &len)) handle_error(interp, "FAILED TO READ INPUT. ", in->line);
+
+    // STR, INT e FLOAT si leggono direttamente dallo span (i numeri validati e convertiti
+    // in una passata); CHAR e BOOL sono brevi e vanno terminati
+    Value value = {0};
+    NumberStatus status = NUMBER_OK;
+    char input_value[256];
+    switch (in->type) {
+        case TYPE_STR:
+            if (len == 0) handle_error(interp, "INPUT VALUE DOES NOT MATCH EXPECTED TYPE. ", in->line);
+            break;
+        case TYPE_INT:
+            status = parse_int(line, len, &value.i_val);
+            break;
+        case TYPE_FLOAT:
+            status = parse_float(line, len, &value.f_val);
+            break;
+        default:
+            if (len >= sizeof(input_value)) handle_error(interp, "INPUT VALUE DOES NOT MATCH EXPECTED TYPE. ", in->line);
+            memcpy(input_value, line, len);
+            input_value[len] = '\0';
+            if (!is_valid_input(input_value, in->type)) handle_error(interp, "INPUT VALUE DOES NOT MATCH EXPECTED TYPE. ", in->line);
+            const char *error = parse_value(input_value, in->type, &value);
+            if (error) handle_error(interp, error, in->line);
+    }
+    if (status == NUMBER_RANGE) handle_error(interp, "INPUT VALUE OUT OF RANGE. ", in->line);
+    if (status != NUMBER_OK) handle_error(interp, "INPUT VALUE DOES NOT MATCH EXPECTED TYPE. ", in->line);
+
+    Variable *var = declare_variable(interp, in->slot, in->type, false, in->line);
+    if (in->type == TYPE_STR) string_assign(interp, &var->value.s_val, line, len);
+    else var->value = value;
+}
+
+// INCREMENT (delta 1) e DECREMENT (delta -1); la usa anche il C generato con --emit-c
+void step_variable(Interpreter *interp, int slot, int delta, int line_number) {
+    Variable *var = &interp->stack[slot];
+    bool is_increment = delta > 0;
+
+    if (!var->is_declared) handle_error(interp, is_increment ? "VARIABLE NOT FOUND." : "VARIABLE NOT FOUND. ", line_number);
+    if (var->type != TYPE_INT && var->type != TYPE_FLOAT)
+        handle_error(interp, is_increment ? "INCREMENT ONLY WORKS WITH INTEGER AND FLOAT VARIABLES. "
+                                          : "DECREMENT ONLY WORKS WITH INTEGER AND FLOAT VARIABLES. ", line_number);
+    if (var->type == TYPE_FLOAT) var->value.f_val += delta;
+    else var->value.i_val = calc_add_int(interp, var->value.i_val, delta, line_number);
+}
+
+// Nome del comando corrispondente a un'istruzione (report del profiler e trace)
+const char *get_opcode_name(OpCode op) {
+    static const char *names[] = {"CLEAR", "EXIT", "LINE", "CALC", "SET", "SAY", "LISTEN", "INCREMENT", "DECREMENT", "ERROR",
+                                  "ARRAY", "FILL", "MAP", "SUM", "MIN", "MAX", "MEAN", "DOT", "IF", "ELSE",
+                                  "WHILE", "REPEAT", "ENDO"};
+    return (unsigned)op < sizeof(names) / sizeof(names[0]) ? names[op] : "?";
+}
+
+static inline void run_set(Interpreter *interp, const Program *program, const Instruction *in) {
+    Variable *var = declare_variable(interp, in->slot, in->type, in->is_const, in->line);
+    if (in->type == TYPE_STR) string_assign(interp, &var->value.s_val, get_string(program, in->text), in->imm.s_val.len);
+    else var->value = in->imm;
+}
+
+static inline void run_say(Interpreter *interp, const Program *program, const Instruction *in) {
+    render_template(interp, program, in->tpl, in->tpl_len, output_buffer(interp));
+    output_commit(interp);
+}
+
+static void run_exit(Interpreter *interp, const Program *program, const Instruction *in) {
+    if (in->tpl != NO_TEXT) {
+        render_template(interp, program, in->tpl, in->tpl_len, output_buffer(interp));
+        output_write(interp, "\n", 1);
+    } else
+        output_write(interp, "Exiting program... Goodbye!\n", 28);
+    output_flush(interp);
+}
+
+// Condizione di IF e WHILE: true se il blocco va eseguito
+static inline bool test_condition(Interpreter *interp, const Program *program, const Instruction *in) {
+    return is_true(evaluate(interp, program, in));
+}
+
+// Fine del corpo di un ciclo: WHILE torna sempre alla condizione, REPEAT solo finché restano giri
+static inline bool loop_again(Interpreter *interp, const Instruction *in) {
+    return in->slot < 0 || --interp->stack[in->slot].value.i_val > 0;
+}
+
+/// ----------------- VM -----------------
+// Esegue una istruzione; false quando il programma termina (EXIT).
+// *pc indica già l'istruzione successiva: IF ed ELSE lo spostano con un solo salto
+static inline bool execute_instruction(Interpreter *interp, const Program *program, const Instruction *in, size_t *pc) {
+    switch (in->op) {
+        case OP_CLEAR:
+            output_write(interp, "\033[H\033[J", 6);
+            break;
+
+        case OP_EXIT:
+            run_exit(interp, program, in);
+            return false;
+
+        case OP_LINE:
+            run_line(interp, program, in);
+            break;
+
+        case OP_CALC:
+            run_calc(interp, program, in);
+            break;
+
+        case OP_SET:
+            run_set(interp, program, in);
+            break;
+
+        case OP_SAY:
+            run_say(interp, program, in);
+            break;
+
+        case OP_LISTEN:
+            run_listen(interp, program, in);
+            break;
+
+        case OP_INCREMENT:
+            step_variable(interp, in->slot, 1, in->line);
+            break;
+
+        case OP_DECREMENT:
+            step_variable(interp, in->slot, -1, in->line);
+            break;
+
+        case OP_ERROR:
+            handle_error(interp, get_string(program, in->text), in->line);
+            break;
+
+        case OP_ARRAY:
+            run_array(interp, program, in);
+            break;
+
+        case OP_FILL:
+        case OP_MAP:
+            run_bulk(interp, program, in);
+            break;
+
+        case OP_SUM:
+        case OP_MIN:
+        case OP_MAX:
+        case OP_MEAN:
+        case OP_DOT:
+            run_reduce(interp, in);
+            break;
+
+        case OP_BRANCH:
+        case OP_WHILE:
+            if (!test_condition(interp, program, in)) *pc = in->jump;
+            break;
+
+        case OP_JUMP:
+            *pc = in->jump;
+            break;
+
+        case OP_REPEAT:
+            run_repeat(interp, program, in, pc);
+            break;
+
+        case OP_NEXT:
+            if (loop_again(interp, in)) *pc = in->jump;
+            break;
+    }
+    return true;
+}
+
+#if VM_THREADED
+// Dispatch diretto: la tabella associa a ogni opcode l'indirizzo del suo handler e ogni
+// handler termina saltando al successivo, così c'è un solo salto indiretto per istruzione
+// (ciascuno con la propria storia nel predittore) invece del salto condiviso dello switch
+static bool execute_threaded(Interpreter *interp, const Program *program) {
+    static const void *const handlers[] = {
+        [OP_CLEAR] = &&op_clear, [OP_EXIT] = &&op_exit, [OP_LINE] = &&op_line, [OP_CALC] = &&op_calc,
+        [OP_SET] = &&op_set, [OP_SAY] = &&op_say, [OP_LISTEN] = &&op_listen, [OP_INCREMENT] = &&op_increment,
+        [OP_DECREMENT] = &&op_decrement, [OP_ERROR] = &&op_error, [OP_ARRAY] = &&op_array, [OP_FILL] = &&op_bulk,
+        [OP_MAP] = &&op_bulk, [OP_SUM] = &&op_reduce, [OP_MIN] = &&op_reduce, [OP_MAX] = &&op_reduce,
+        [OP_MEAN] = &&op_reduce, [OP_DOT] = &&op_reduce, [OP_BRANCH] = &&op_branch, [OP_JUMP] = &&op_jump,
+        [OP_WHILE] = &&op_branch, [OP_REPEAT] = &&op_repeat, [OP_NEXT] = &&op_next
+    };
+    _Static_assert(sizeof(handlers) / sizeof(handlers[0]) == OP_NEXT + 1, "ogni opcode deve avere un handler");
+
+    const Instruction *code = program->code;
+    const Instruction *end = code + program->count;
+    const Instruction *next = code; // istruzione successiva, come pc nello switch
+    const Instruction *in;
+
+#define DISPATCH() do { if (next == end) return true; in = next++; goto *handlers[in->op]; } while (0)
+
+    DISPATCH();
+
+op_clear:
+    output_write(interp, "\033[H\033[J", 6);
+    DISPATCH();
+op_exit:
+    run_exit(interp, program, in);
+    return false;
+op_line:
+    run_line(interp, program, in);
+    DISPATCH();
+op_calc:
+    run_calc(interp, program, in);
+    DISPATCH();
+op_set:
+    run_set(interp, program, in);
+    DISPATCH();
+op_say:
+    run_say(interp, program, in);
+    DISPATCH();
+op_listen:
+    run_listen(interp, program, in);
+    DISPATCH();
+op_increment:
+    step_variable(interp, in->slot, 1, in->line);
+    DISPATCH();
+op_decrement:
+    step_variable(interp, in->slot, -1, in->line);
+    DISPATCH();
+op_error:
+    handle_error(interp, get_string(program, in->text), in->line);
+    DISPATCH();
+op_array:
+    run_array(interp, program, in);
+    DISPATCH();
+op_bulk:
+    run_bulk(interp, program, in);
+    DISPATCH();
+op_reduce:
+    run_reduce(interp, in);
+    DISPATCH();
+op_branch:
+    if (!test_condition(interp, program, in)) next = code + in->jump;
+    DISPATCH();
+op_jump:
+    next = code + in->jump;
+    DISPATCH();
+op_repeat: {
+    size_t pc = (size_t)(next - code);
+    run_repeat(interp, program, in, &pc);
+    next = code + pc;
+    DISPATCH();
+}
+op_next:
+    if (loop_again(interp, in)) next = code + in->jump;
+    DISPATCH();
+
+#undef DISPATCH
+}
+#endif
+
+// Variante strumentata: trace e misura di ogni istruzione (--profile, --trace)
+static bool execute_instrumented(Interpreter *interp, const Program *program) {
+    size_t pc = 0;
+    while (pc < program->count) {
+        const Instruction *in = &program->code[pc++];
+        TRACE(TRACE_EXEC, "TRACE: LINE %d %s\n", in->line, get_opcode_name(in->op));
+
+        if (!profiling_enabled) {
+            if (!execute_instruction(interp, program, in, &pc)) return false;
+            continue;
+        }
+        profile_enter(in->line, in->op, get_opcode_name(in->op));
+        uint64_t started = profiler_now();
+        bool running = execute_instruction(interp, program, in, &pc);
+        profile_leave(profiler_now() - started);
+        if (!running) return false;
+    }
+    return true;
+}
+
+// Esegue le istruzioni in ordine, senza più rileggere né ritokenizzare il sorgente;
+// false se il programma è terminato con EXIT
+bool execute_program(Interpreter *interp, const Program *program) {
+    if (profiling_enabled || (NOOBIE_TRACE && trace_level > 0))
+        return execute_instrumented(interp, program);
+#if VM_THREADED
+    return execute_threaded(interp, program);
+#else
+    size_t pc = 0;
+    while (pc < program->count) {
+        const Instruction *in = &program->code[pc++];
+        if (!execute_instruction(interp, program, in, &pc)) return false;
+    }
+    return true;
+#endif
+}
+
+// Esegue una sola istruzione senza salti (codice generato da --emit-c per LISTEN, array e
+// LINE dinamici); false se è EXIT
+bool execute_single(Interpreter *interp, const Program *program, const Instruction *in) {
+    size_t pc = 0;
+    return execute_instruction(interp, program, in, &pc);
+}
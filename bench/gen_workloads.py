@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+# Genera i carichi di lavoro sintetici (.nob) usati dal benchmark.
+# L'output è deterministico: stesso seed e stessa scala producono gli stessi file.
+#
+# Uso: python3 gen_workloads.py <cartella> [--scale N] [--seed S]
+
+import argparse
+import os
+import random
+
+TYPES = ["INT", "FLOAT", "STR", "BOOL", "CHAR"]
+
+
+def literal(rng, vtype):
+    if vtype == "INT":
+        return str(rng.randint(-100000, 100000))
+    if vtype == "FLOAT":
+        return "%.3f" % rng.uniform(-1000, 1000)
+    if vtype == "STR":
+        return "".join(rng.choice("abcdefghijklmnopqrstuvwxyz") for _ in range(rng.randint(3, 24)))
+    if vtype == "BOOL":
+        return rng.choice(["true", "false"])
+    return rng.choice("abcdefghijklmnopqrstuvwxyz")
+
+
+# Migliaia di SET di tutti i tipi
+def declarations(rng, scale):
+    lines = []
+    for i in range(20000 * scale):
+        vtype = TYPES[i % len(TYPES)]
+        const = "CONST " if i % 7 == 0 else ""
+        lines.append("SET %s%s v%d %s" % (const, vtype, i, literal(rng, vtype)))
+    return lines, None
+
+
+# Espressioni profonde (parentesi annidate) e larghe (molti termini)
+def calculations(rng, scale):
+    lines = ["SET INT a 7", "SET INT b 3", "SET FLOAT f 1.5", "SET BOOL t true"]
+    operands = ["a", "b", "f", "2", "3.5", "11"]
+    arith = ["+", "-", "*"]
+
+    def deep(depth):
+        if depth == 0:
+            return rng.choice(operands)
+        return "(%s %s %s)" % (rng.choice(operands), rng.choice(arith), deep(depth - 1))
+
+    def wide(terms):
+        expr = rng.choice(operands)
+        for _ in range(terms - 1):
+            expr += " %s %s" % (rng.choice(arith), rng.choice(operands))
+        return expr
+
+    for i in range(5000 * scale):
+        kind = i % 4
+        if kind == 0:
+            lines.append("CALC " + deep(rng.randint(8, 60)))
+        elif kind == 1:
+            lines.append("CALC " + wide(rng.randint(16, 120)))
+        elif kind == 2:
+            lines.append("CALC (a > b AND t) OR NOT (f < %d) XOR a == %d" % (rng.randint(0, 9), rng.randint(0, 9)))
+        else:
+            lines.append("CALC a %% b + a / b - a ** 2 + f * %d" % rng.randint(1, 50))
+    return lines, None
+
+
+# SAY con molte interpolazioni @nome e #nome
+def interpolation(rng, scale):
+    lines = []
+    names = []
+    for i in range(32):
+        vtype = TYPES[i % len(TYPES)]
+        names.append("s%d" % i)
+        lines.append("SET %s s%d %s" % (vtype, i, literal(rng, vtype)))
+
+    for _ in range(20000 * scale):
+        parts = []
+        for _ in range(rng.randint(4, 12)):
+            name = rng.choice(names)
+            parts.append("%s=%s%s" % (name, rng.choice("@@@#"), name))
+        lines.append('SAY "%s\\n"' % " ".join(parts))
+    return lines, None
+
+
+# LINE molto lunghe, con motivi di lunghezza diversa
+def long_lines(rng, scale):
+    lines = ["SET INT width 100000"]
+    patterns = ["=", "-", "ab", "<>", "*-*", "0123456789"]
+    for i in range(200 * scale):
+        if i % 2:
+            lines.append("LINE @width %s" % rng.choice(patterns))
+        else:
+            lines.append("LINE %d %s" % (rng.randint(10000, 200000), rng.choice(patterns)))
+    return lines, None
+
+
+# LISTEN con input già scritto su file
+def scripted_input(rng, scale):
+    lines = []
+    answers = []
+    for i in range(3000 * scale):
+        vtype = ["INT", "FLOAT", "STR", "BOOL", "CHAR"][i % 5]
+        lines.append('LISTEN %s in%d "value %d: "' % (vtype, i, i))
+        answers.append(literal(rng, vtype))
+        if i % 10 == 9:
+            lines.append('SAY "got @in%d\\n"' % i)
+    return lines, answers
+
+
+# Cicli annidati: poche righe di sorgente, milioni di istruzioni eseguite dalla memoria
+def loops(rng, scale):
+    lines = ["SET INT i 0", "SET INT hits 0", "SET FLOAT acc 0.5"]
+    lines.append("WHILE i < %d DO" % (20000 * scale))
+    lines.append("    INCREMENT i")
+    lines.append("    REPEAT %d DO" % rng.randint(20, 40))
+    lines.append("        INCREMENT hits")
+    lines.append("        IF hits %% %d == 0 DO" % rng.randint(3, 9))
+    lines.append("            INCREMENT acc")
+    lines.append("        ENDO")
+    lines.append("    ENDO")
+    lines.append("ENDO")
+    lines.append('SAY "i=@i hits=@hits acc=@acc\\n"')
+    return lines, None
+
+
+WORKLOADS = [
+    ("declarations", declarations),
+    ("calculations", calculations),
+    ("interpolation", interpolation),
+    ("long_lines", long_lines),
+    ("scripted_input", scripted_input),
+    ("loops", loops),
+]
+
+
+def generate(directory, scale=1, seed=2022):
+    os.makedirs(directory, exist_ok=True)
+    generated = []
+    for name, build in WORKLOADS:
+        rng = random.Random("%s-%d" % (name, seed))
+        lines, answers = build(rng, scale)
+        script = os.path.join(directory, name + ".nob")
+        with open(script, "w") as f:
+            f.write("\n".join(lines) + "\n")
+
+        stdin = None
+        if answers is not None:
+            stdin = os.path.join(directory, name + ".in")
+            with open(stdin, "w") as f:
+                f.write("\n".join(answers) + "\n")
+        generated.append((name, script, stdin))
+    return generated
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Genera i carichi di lavoro .nob del benchmark")
+    parser.add_argument("directory")
+    parser.add_argument("--scale", type=int, default=1)
+    parser.add_argument("--seed", type=int, default=2022)
+    args = parser.parse_args()
+
+    for name, script, stdin in generate(args.directory, args.scale, args.seed):
+        print("%-16s %s%s" % (name, script, " < " + stdin if stdin else ""))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,231 @@
+// Microbenchmark delle funzioni interne dell'interprete: tokenizer, valutazione delle
+// espressioni (anche in codice nativo), classificazione delle righe, ricerca delle variabili, espansione dei
+// messaggi, kernel degli array e API di libnoobie.
+// Viene compilato da run_bench.py insieme ai sorgenti di 2.2 (senza noobie-2_2.c).
+//
+// Uso: micro_bench [iterazioni]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "helper_function-2.2.h"
+#include "calc_parser.h"
+#include "profiler-2.2.h"
+#include "libnoobie-2.2.h"
+#include "array-2.2.h"
+#include "string-2.2.h"
+#include "scan-2.2.h"
+#include "number-2.2.h"
+#include "jit-2.2.h"
+
+static Interpreter interp; // Contesto condiviso da tutti i benchmark
+
+#define VAR_COUNT 1000
+
+static const char *expression = "(a + b * 3) - c / 2 + (d % 7) * (a - b) > 10 AND flag OR NOT flag";
+static const char *message = "a=@a b=@b c=@c d=@d flag=@flag name=@name type=#name missing=@missing\\n";
+
+static volatile int64_t sink; // Impedisce al compilatore di eliminare i cicli misurati
+
+static void report(const char *name, long iterations, uint64_t elapsed) {
+    printf("%-22s %10ld %12.1f ns/op %14.0f ops/s\n", name, iterations,
+           (double)elapsed / iterations, iterations * 1e9 / (double)elapsed);
+}
+
+// Dichiara le variabili usate dai benchmark
+static void setup(void) {
+    init_interpreter(&interp);
+    const char *names[] = {"a", "b", "c", "d"};
+    for (int i = 0; i < 4; i++) {
+        Variable *var = declare_variable(&interp, intern_variable(&interp, names[i]), TYPE_INT, false, 0);
+        var->value.i_val = 10 + i * 7;
+    }
+    declare_variable(&interp, intern_variable(&interp, "flag"), TYPE_BOOL, false, 0)->value.b_val = true;
+    string_assign(&interp, &declare_variable(&interp, intern_variable(&interp, "name"), TYPE_STR, false, 0)->value.s_val, "noobie", 6);
+
+    char name[32];
+    for (int i = 0; i < VAR_COUNT; i++) {
+        snprintf(name, sizeof(name), "var_%d", i);
+        declare_variable(&interp, intern_variable(&interp, name), TYPE_INT, false, 0)->value.i_val = i;
+    }
+}
+
+static void bench_tokenizer(long iterations) {
+    uint64_t started = profiler_now();
+    for (long i = 0; i < iterations; i++) {
+        Tokenizer tokenizer;
+        init_tokenizer(&tokenizer, expression);
+        Token token;
+        do {
+            token = get_next_token(&tokenizer);
+            sink += token.type;
+        } while (token.type != TOKEN_END && token.type != TOKEN_ERROR);
+    }
+    report("get_next_token", iterations, profiler_now() - started);
+}
+
+static void bench_evaluate_expression(long iterations) {
+    uint64_t started = profiler_now();
+    for (long i = 0; i < iterations; i++) sink += evaluate_expression(&interp, expression, 0).value.b_val;
+    report("evaluate_expression", iterations, profiler_now() - started);
+}
+
+static void bench_evaluate_compiled(long iterations) {
+    ExprCode code;
+    init_expr_code(&code);
+    if (compile_expression(&interp, expression, &code)) handle_error(NULL, "BENCHMARK EXPRESSION DOES NOT COMPILE. ", 0);
+
+    uint64_t started = profiler_now();
+    for (long i = 0; i < iterations; i++) sink += evaluate_compiled(&interp, code.ops, code.count, 0).value.b_val;
+    report("evaluate_compiled", iterations, profiler_now() - started);
+    free_expr_code(&code);
+}
+
+// La stessa espressione tradotta dal JIT (uguale a evaluate_compiled dove non è disponibile)
+static void bench_jit(long iterations) {
+    ExprCode code;
+    init_expr_code(&code);
+    if (compile_expression(&interp, expression, &code)) handle_error(NULL, "BENCHMARK EXPRESSION DOES NOT COMPILE. ", 0);
+    JitCache *cache = new_jit_cache();
+
+    uint64_t started = profiler_now();
+    for (long i = 0; i < iterations; i++) sink += jit_evaluate(&interp, cache, &code, 0, (uint32_t)code.count, 0).value.b_val;
+    report(jit_available() ? "jit_evaluate" : "jit_evaluate (none)", iterations, profiler_now() - started);
+    free_jit_cache(cache);
+    free_expr_code(&code);
+}
+
+// Un solo passaggio su una riga lunga con commenti, trattini e virgolette
+static void bench_scan_line(long iterations) {
+    static const char *line = "SAY \"totale: @a - parziale: @b <nota sul calcolo> valori @c @d\" -- commento finale della riga\n";
+    size_t len = strlen(line);
+    LineMarks marks = {0};
+
+    char name[48];
+    snprintf(name, sizeof(name), "scan_line (%s)", get_scan_kernel_name());
+    uint64_t started = profiler_now();
+    for (long i = 0; i < iterations; i++) {
+        scan_line(line, len, &marks);
+        sink += (int64_t)marks.count;
+    }
+    report(name, iterations, profiler_now() - started);
+    free_line_marks(&marks);
+}
+
+// Lettura e scrittura di INT e FLOAT come fanno LISTEN, SET e SAY
+static void bench_numbers(long iterations) {
+    static const char *ints[] = {"0", "-42", "123456", "9223372036854775807"};
+    static const char *floats[] = {"3.14", "-0.001", "123456.789", "2.5e10"};
+    char text[NUMBER_TEXT_SIZE];
+
+    uint64_t started = profiler_now();
+    for (long i = 0; i < iterations; i++) {
+        int64_t value;
+        double real;
+        const char *a = ints[i & 3], *b = floats[i & 3];
+        parse_int(a, strlen(a), &value);
+        parse_float(b, strlen(b), &real);
+        sink += (int64_t)format_int(text, value);
+        sink += (int64_t)format_fixed(text, real, 2);
+    }
+    report("parse/format numbers", iterations, profiler_now() - started);
+}
+
+static void bench_find_variable(long iterations) {
+    char names[64][32];
+    for (int i = 0; i < 64; i++) snprintf(names[i], sizeof(names[i]), "var_%d", (i * 37) % VAR_COUNT);
+
+    uint64_t started = profiler_now();
+    for (long i = 0; i < iterations; i++) sink += find_variable(&interp, names[i & 63])->value.i_val;
+    report("find_variable", iterations, profiler_now() - started);
+}
+
+static void bench_expand_variables(long iterations) {
+    char output[1024];
+    uint64_t started = profiler_now();
+    for (long i = 0; i < iterations; i++) {
+        expand_variables(&interp, message, output, sizeof(output));
+        sink += output[0];
+    }
+    report("expand_variables", iterations, profiler_now() - started);
+}
+
+// Riduzioni sugli array con il set di kernel scelto a runtime (NOOBIE_SIMD per forzarlo)
+static void bench_array(long iterations) {
+    Array *a = new_array(TYPE_FLOAT, 4096);
+    Array *b = new_array(TYPE_FLOAT, 4096);
+    for (size_t i = 0; i < a->len; i++) {
+        a->data.f[i] = (double)i * 0.5;
+        b->data.f[i] = (double)(a->len - i);
+    }
+
+    char name[48];
+    snprintf(name, sizeof(name), "SUM 4096 (%s)", get_array_kernels_name());
+    uint64_t started = profiler_now();
+    for (long i = 0; i < iterations; i++)
+        sink += (int64_t)reduce_array(&interp, a, REDUCE_SUM, 0).value.f_val;
+    report(name, iterations, profiler_now() - started);
+
+    snprintf(name, sizeof(name), "DOT 4096 (%s)", get_array_kernels_name());
+    started = profiler_now();
+    for (long i = 0; i < iterations; i++)
+        sink += (int64_t)dot_arrays(&interp, a, b, 0).value.f_val;
+    report(name, iterations, profiler_now() - started);
+
+    free_array(a);
+    free_array(b);
+}
+
+static void discard_output(void *user_data, const char *data, size_t len) {
+    (void)user_data, (void)data;
+    sink += (int64_t)len;
+}
+
+// Chiamate dell'API incorporabile: contesto nuovo, script breve e singola espressione
+static void bench_libnoobie(long iterations) {
+    static const char *script = "SET INT a 5\nSET FLOAT f 2.5\nCALC a * f + 1\nSAY \"a=@a f=@f\\n\"\n";
+
+    uint64_t started = profiler_now();
+    for (long i = 0; i < iterations; i++) {
+        NoobieContext *ctx = noobie_create();
+        noobie_set_output(ctx, discard_output, NULL);
+        if (noobie_eval(ctx, script, NOOBIE_NUL_TERMINATED) != NOOBIE_OK)
+            handle_error(NULL, "BENCHMARK SCRIPT FAILED. ", 0);
+        noobie_destroy(ctx);
+    }
+    report("noobie_eval (new ctx)", iterations, profiler_now() - started);
+
+    NoobieContext *ctx = noobie_create();
+    noobie_set(ctx, "a", noobie_int(10));
+    noobie_set(ctx, "b", noobie_int(3));
+    NoobieValue value;
+    started = profiler_now();
+    for (long i = 0; i < iterations; i++) {
+        noobie_calc(ctx, "a * b + a % b", &value);
+        sink += value.as.i_val;
+    }
+    report("noobie_calc", iterations, profiler_now() - started);
+    noobie_destroy(ctx);
+}
+
+int main(int argc, char *argv[]) {
+    long iterations = argc > 1 ? atol(argv[1]) : 200000;
+    if (iterations <= 0) handle_error(NULL, "USAGE: micro_bench [iterations] ", -1);
+
+    setup();
+    bench_tokenizer(iterations);
+    bench_evaluate_expression(iterations);
+    bench_evaluate_compiled(iterations);
+    bench_jit(iterations);
+    bench_scan_line(iterations);
+    bench_numbers(iterations);
+    bench_find_variable(iterations * 10);
+    bench_expand_variables(iterations);
+    bench_array(iterations / 100);
+    bench_libnoobie(iterations / 4);
+    free_interpreter(&interp);
+    return 0;
+}
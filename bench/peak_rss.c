@@ -0,0 +1,46 @@
+// Esegue un comando e scrive il suo picco di RSS (KiB) in un file.
+// Serve a run_bench.py: un figlio creato direttamente da Python eredita il picco di memoria
+// del processo Python, mentre un figlio di questo programma parte da un processo minimo.
+//
+// Uso: peak_rss <file_risultato> <comando> [argomenti...]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "USAGE: peak_rss <result_file> <command> [args...]\n");
+        return 2;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return 2;
+    }
+    if (pid == 0) {
+        execv(argv[2], &argv[2]);
+        perror("execv");
+        _exit(127);
+    }
+
+    int status;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0) {
+        perror("wait4");
+        return 2;
+    }
+
+    FILE *result = fopen(argv[1], "w");
+    if (!result) {
+        perror("fopen");
+        return 2;
+    }
+    fprintf(result, "%ld\n", usage.ru_maxrss);
+    fclose(result);
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+}
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+# Benchmark riproducibile: compila interprete e microbenchmark, genera i carichi di lavoro,
+# misura statement/s, CALC/s, byte di output/s e picco di RSS, e scrive bench_output.txt
+# nella radice del repository per confrontare esecuzioni su commit diversi.
+#
+# Uso: python3 bench/run_bench.py [--scale N] [--repeat N] [--output file]
+# Variabili d'ambiente: CC (default gcc), CFLAGS (default -O2)
+
+import argparse
+import datetime
+import glob
+import os
+import platform
+import shlex
+import subprocess
+import sys
+import tempfile
+import time
+
+import gen_workloads
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(BENCH_DIR)
+SOURCES = os.path.join(ROOT, "2.2")
+
+
+def build(directory):
+    cc = os.environ.get("CC", "gcc")
+    cflags = shlex.split(os.environ.get("CFLAGS", "-O2"))
+    sources = sorted(glob.glob(os.path.join(SOURCES, "*.c"))) + [os.path.join(ROOT, "calc_parser.c")]
+    library = [s for s in sources if not s.endswith("noobie-2_2.c")]
+    includes = ["-I" + SOURCES, "-I" + ROOT]
+
+    interpreter = os.path.join(directory, "noobie")
+    micro = os.path.join(directory, "micro_bench")
+    probe = os.path.join(directory, "peak_rss")
+    subprocess.run([cc, *cflags, *includes, *sources, "-lm", "-pthread", "-o", interpreter], check=True)
+    subprocess.run([cc, *cflags, *includes, *library, os.path.join(BENCH_DIR, "micro_bench.c"),
+                    "-lm", "-pthread", "-o", micro], check=True)
+    subprocess.run([cc, *cflags, os.path.join(BENCH_DIR, "peak_rss.c"), "-o", probe], check=True)
+    return interpreter, micro, probe, " ".join([cc, *cflags])
+
+
+# Esegue lo script una volta: tempo reale, byte scritti su stdout e picco di RSS (KiB)
+def run_once(interpreter, probe, script, stdin_path, scratch):
+    stdout_path = os.path.join(scratch, "stdout")
+    rss_path = os.path.join(scratch, "rss")
+    # Le risposte di LISTEN vengono rigiocate con --input (stesso formato di --record)
+    command = [probe, rss_path, interpreter] + (["--input", stdin_path] if stdin_path else []) + [script]
+    with open(stdout_path, "wb") as out, open(os.devnull, "rb") as inp:
+        started = time.perf_counter()
+        proc = subprocess.run(command, stdin=inp, stdout=out, stderr=subprocess.PIPE)
+        elapsed = time.perf_counter() - started
+
+    if proc.returncode != 0:
+        sys.exit("%s failed (exit %d): %s" % (os.path.basename(script), proc.returncode,
+                                              proc.stderr.decode(errors="replace").strip()))
+    with open(rss_path) as f:
+        peak_rss = int(f.read())
+    return elapsed, os.path.getsize(stdout_path), peak_rss
+
+
+def count_statements(script):
+    statements = calcs = 0
+    with open(script) as f:
+        for line in f:
+            word = line.split(None, 1)[0].upper() if line.strip() else ""
+            if word:
+                statements += 1
+                calcs += word == "CALC"
+    return statements, calcs
+
+
+def git_revision():
+    try:
+        return subprocess.run(["git", "-C", ROOT, "rev-parse", "--short", "HEAD"],
+                              capture_output=True, text=True, check=True).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return "unknown"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark dell'interprete noobie")
+    parser.add_argument("--scale", type=int, default=1, help="moltiplicatore della dimensione dei carichi")
+    parser.add_argument("--repeat", type=int, default=5, help="esecuzioni per carico (si tiene la migliore)")
+    parser.add_argument("--iterations", type=int, default=200000, help="iterazioni dei microbenchmark")
+    parser.add_argument("--output", default=os.path.join(ROOT, "bench_output.txt"))
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory(prefix="noobie-bench-") as scratch:
+        interpreter, micro, probe, compiler = build(scratch)
+        workloads = gen_workloads.generate(os.path.join(scratch, "workloads"), args.scale)
+
+        report = [
+            "noobie benchmark",
+            "commit:   %s" % git_revision(),
+            "date:     %s" % datetime.datetime.now().strftime("%Y-%m-%d %H:%M:%S"),
+            "host:     %s %s" % (platform.system(), platform.machine()),
+            "compiler: %s" % compiler,
+            "scale:    %d, best of %d" % (args.scale, args.repeat),
+            "",
+            "%-16s %10s %10s %14s %14s %14s %10s" % (
+                "WORKLOAD", "STMTS", "TIME(ms)", "STMTS/s", "CALC/s", "OUT MB/s", "RSS(KiB)"),
+        ]
+
+        for name, script, stdin_path in workloads:
+            statements, calcs = count_statements(script)
+            runs = [run_once(interpreter, probe, script, stdin_path, scratch) for _ in range(args.repeat)]
+            elapsed = min(run[0] for run in runs)
+            output_bytes = runs[0][1]
+            peak_rss = max(run[2] for run in runs)
+            report.append("%-16s %10d %10.2f %14.0f %14.0f %14.2f %10d" % (
+                name, statements, elapsed * 1e3, statements / elapsed, calcs / elapsed,
+                output_bytes / elapsed / 1e6, peak_rss))
+
+        report += ["", "MICROBENCHMARKS"]
+        micro_run = subprocess.run([micro, str(args.iterations)], capture_output=True, text=True, check=True)
+        report += micro_run.stdout.rstrip("\n").split("\n")
+
+    text = "\n".join(report) + "\n"
+    with open(args.output, "w") as f:
+        f.write(text)
+    sys.stdout.write(text)
+    print("\nwritten %s" % args.output)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,4 +1,5 @@
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <ctype.h>
 #include <stdlib.h>
@@ -6,12 +7,17 @@
 #include <stdbool.h>
 
 #include "calc_parser.h"
+#include "keywords-2.2.h"
+#include "number-2.2.h"
+#include "string-2.2.h"
+#include "profiler-2.2.h"
 
 // Inizializza il tokenizer
 void init_tokenizer(Tokenizer *tokenizer, const char *input) {
     tokenizer->input = input;
     tokenizer->pos = 0;
     tokenizer->length = strlen(input);
+    tokenizer->has_lookahead = false;
 }
 
 // Salta gli spazi bianchi
@@ -30,672 +36,665 @@ bool is_alnum_or_underscore(char c) {
     return isalnum(c) || c == '_';
 }
 
-// Controlla se una stringa è un operatore
-bool is_operator(const char *str) {
-    const char *operators[] = {
-        "***", "**", "+", "-", "*", "/", "%",
-        "AND", "OR", "XOR", "NOT",
-        "==", "!=", "<=", ">=", "<", ">"
-    };
-    int num_operators = sizeof(operators) / sizeof(operators[0]);
-    
-    for (int i = 0; i < num_operators; i++) {
-        if (strcmp(str, operators[i]) == 0) {
-            return true;
-        }
-    }
-    return false;
+// Tabella degli operatori: simbolo, precedenza binaria (0 = non binario) e uso come prefisso.
+// Un nuovo operatore richiede solo una riga qui (più il riconoscimento nel tokenizer).
+typedef struct {
+    const char *symbol;
+    int precedence;
+    bool is_prefix;
+} OperatorInfo;
+
+static const OperatorInfo operator_table[] = {
+    [OPERATOR_NONE]     = {"",    0, false},
+    [OPERATOR_OR]       = {"OR",  1, false},
+    [OPERATOR_XOR]      = {"XOR", 2, false},
+    [OPERATOR_AND]      = {"AND", 3, false},
+    [OPERATOR_EQ]       = {"==",  4, false},
+    [OPERATOR_NE]       = {"!=",  4, false},
+    [OPERATOR_LT]       = {"<",   5, false},
+    [OPERATOR_GT]       = {">",   5, false},
+    [OPERATOR_LE]       = {"<=",  5, false},
+    [OPERATOR_GE]       = {">=",  5, false},
+    [OPERATOR_ADD]      = {"+",   6, true},
+    [OPERATOR_SUB]      = {"-",   6, true},
+    [OPERATOR_MUL]      = {"*",   7, false},
+    [OPERATOR_DIV]      = {"/",   7, false},
+    [OPERATOR_MOD]      = {"%",   7, false},
+    [OPERATOR_POW]      = {"**",  8, false},
+    [OPERATOR_SAFE_POW] = {"***", 8, false},
+    [OPERATOR_NOT]      = {"NOT", 0, true},
+};
+
+// Precedenza binaria dell'operatore (più alta = lega di più, 0 = non binario)
+int get_operator_precedence(OperatorKind op) {
+    return operator_table[op].precedence;
+}
+
+// Costruisce un token che copre [start, pos) dell'input
+static Token make_token(Tokenizer *tokenizer, TokenType type, size_t start) {
+    Token token = {type, OPERATOR_NONE, false, (uint32_t)start, (uint32_t)(tokenizer->pos - start), 0.0, 0, false};
+    return token;
 }
 
+// Token operatore di len caratteri
+static Token make_operator(Tokenizer *tokenizer, OperatorKind op, size_t len) {
+    size_t start = tokenizer->pos;
+    tokenizer->pos += len;
+    Token token = make_token(tokenizer, TOKEN_OPERATOR, start);
+    token.op = op;
+    return token;
+}
+
+// Accumula le cifre di un intero in 64 bit; false se non ci sta
+static bool parse_integer_span(const char *text, size_t length, int64_t *out) {
+    int64_t value = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (__builtin_mul_overflow(value, 10, &value) || __builtin_add_overflow(value, text[i] - '0', &value))
+            return false;
+    }
+    *out = value;
+    return true;
+}
+
+// Converte lo span di un numero con la virgola ("." vale 0, oltre il massimo inf, come atof)
+static double parse_number_span(const char *text, size_t length) {
+    double value = 0.0;
+    if (parse_float(text, length, &value) == NUMBER_RANGE) value = INFINITY;
+    return value;
+}
+
+// Guarda il prossimo token senza consumarlo: viene analizzato una sola volta e tenuto nel buffer
+const Token *peek_token(Tokenizer *tokenizer) {
+    if (!tokenizer->has_lookahead) {
+        tokenizer->lookahead = get_next_token(tokenizer);
+        tokenizer->has_lookahead = true;
+    }
+    return &tokenizer->lookahead;
+}
 
+// Consuma il prossimo token (dal buffer, se presente)
+Token next_token(Tokenizer *tokenizer) {
+    if (tokenizer->has_lookahead) {
+        tokenizer->has_lookahead = false;
+        return tokenizer->lookahead;
+    }
+    return get_next_token(tokenizer);
+}
 
 // Ottiene il prossimo token
 Token get_next_token(Tokenizer *tokenizer) {
-    Token token = {TOKEN_ERROR, "", 0.0};
-    
     skip_whitespace(tokenizer);
     
+    size_t start = tokenizer->pos;
     if (tokenizer->pos >= tokenizer->length) {
-        token.type = TOKEN_END;
-        return token;
+        return make_token(tokenizer, TOKEN_END, start);
     }
     
-    char current = tokenizer->input[tokenizer->pos];
+    const char *input = tokenizer->input;
+    char current = input[tokenizer->pos];
+    char next = tokenizer->pos + 1 < tokenizer->length ? input[tokenizer->pos + 1] : '\0';
     
     // Parentesi
-    if (current == '(') {
-        token.type = TOKEN_LPAREN;
-        token.value[0] = current;
-        token.value[1] = '\0';
-        tokenizer->pos++;
-        return token;
-    }
-    
-    if (current == ')') {
-        token.type = TOKEN_RPAREN;
-        token.value[0] = current;
-        token.value[1] = '\0';
+    if (current == '(' || current == ')') {
         tokenizer->pos++;
-        return token;
+        return make_token(tokenizer, current == '(' ? TOKEN_LPAREN : TOKEN_RPAREN, start);
     }
     
     // Numeri (interi e decimali)
-    if (isdigit(current) || (current == '.' && tokenizer->pos + 1 < tokenizer->length && isdigit(tokenizer->input[tokenizer->pos + 1]))) {
-        size_t start = tokenizer->pos;
+    if (isdigit(current) || (current == '.' && isdigit(next))) {
         bool has_dot = false;
         
         while (tokenizer->pos < tokenizer->length && 
-               (isdigit(tokenizer->input[tokenizer->pos]) || 
-                (tokenizer->input[tokenizer->pos] == '.' && !has_dot))) {
-            if (tokenizer->input[tokenizer->pos] == '.') {
+               (isdigit(input[tokenizer->pos]) || 
+                (input[tokenizer->pos] == '.' && !has_dot))) {
+            if (input[tokenizer->pos] == '.') {
                 has_dot = true;
             }
             tokenizer->pos++;
         }
         
-        size_t length = tokenizer->pos - start;
-        strncpy(token.value, &tokenizer->input[start], length);
-        token.value[length] = '\0';
-        token.number = atof(token.value);
-        token.type = TOKEN_NUMBER;
-        return token;
-    }
-    
-    // Operatori multicarattere e parole chiave
-    if (tokenizer->pos + 2 < tokenizer->length && 
-        strncmp(&tokenizer->input[tokenizer->pos], "***", 3) == 0) {
-        strcpy(token.value, "***");
-        token.type = TOKEN_OPERATOR;
-        tokenizer->pos += 3;
+        Token token = make_token(tokenizer, TOKEN_NUMBER, start);
+        token.is_float = has_dot;
+        if (has_dot) token.number = parse_number_span(&input[start], token.length);
+        else token.overflow = !parse_integer_span(&input[start], token.length, &token.integer);
         return token;
     }
     
-    if (tokenizer->pos + 1 < tokenizer->length) {
-        char two_char[3] = {current, tokenizer->input[tokenizer->pos + 1], '\0'};
-        if (strcmp(two_char, "**") == 0 || strcmp(two_char, "==") == 0 || 
-            strcmp(two_char, "!=") == 0 || strcmp(two_char, "<=") == 0 || 
-            strcmp(two_char, ">=") == 0) {
-            strcpy(token.value, two_char);
-            token.type = TOKEN_OPERATOR;
-            tokenizer->pos += 2;
-            return token;
+    // Operatori simbolici: il più lungo possibile
+    switch (current) {
+        case '*':
+            if (next == '*') {
+                if (tokenizer->pos + 2 < tokenizer->length && input[tokenizer->pos + 2] == '*')
+                    return make_operator(tokenizer, OPERATOR_SAFE_POW, 3);
+                return make_operator(tokenizer, OPERATOR_POW, 2);
+            }
+            return make_operator(tokenizer, OPERATOR_MUL, 1);
+        case '=':
+            if (next == '=') return make_operator(tokenizer, OPERATOR_EQ, 2);
+            break;
+        case '!':
+            if (next == '=') return make_operator(tokenizer, OPERATOR_NE, 2);
+            break;
+        case '<':
+            return next == '=' ? make_operator(tokenizer, OPERATOR_LE, 2) : make_operator(tokenizer, OPERATOR_LT, 1);
+        case '>':
+            return next == '=' ? make_operator(tokenizer, OPERATOR_GE, 2) : make_operator(tokenizer, OPERATOR_GT, 1);
+        case '+': return make_operator(tokenizer, OPERATOR_ADD, 1);
+        case '-': return make_operator(tokenizer, OPERATOR_SUB, 1);
+        case '/': return make_operator(tokenizer, OPERATOR_DIV, 1);
+        case '%': return make_operator(tokenizer, OPERATOR_MOD, 1);
+    }
+    
+    // @nome: riferimento esplicito a una variabile, come nell'interpolazione
+    if (current == '@' && is_alpha_or_underscore(next)) {
+        start = ++tokenizer->pos;
+        while (tokenizer->pos < tokenizer->length && 
+            is_alnum_or_underscore(input[tokenizer->pos])) {
+            tokenizer->pos++;
         }
-    }
-    
-    // Operatori singoli
-    if (current == '+' || current == '-' || current == '*' || current == '/' || 
-        current == '%' || current == '<' || current == '>') {
-        token.value[0] = current;
-        token.value[1] = '\0';
-        token.type = TOKEN_OPERATOR;
-        tokenizer->pos++;
-        return token;
+        return make_token(tokenizer, TOKEN_VARIABLE, start);
     }
     
     // Identificatori (variabili o operatori logici)
     if (is_alpha_or_underscore(current)) {
-        size_t start = tokenizer->pos;
-        
         while (tokenizer->pos < tokenizer->length && 
-            is_alnum_or_underscore(tokenizer->input[tokenizer->pos])) {
+            is_alnum_or_underscore(input[tokenizer->pos])) {
             tokenizer->pos++;
         }
         
-        size_t length = tokenizer->pos - start;
-        strncpy(token.value, &tokenizer->input[start], length);
-        token.value[length] = '\0';
+        Token token = make_token(tokenizer, TOKEN_VARIABLE, start);
 
-        // DEBUG: Stampa il token estratto
-        printf("DEBUG: Token trovato: '%s'\n", token.value);
+        // Trace dei token estratti (--trace=2)
+        TRACE(TRACE_TOKENS, "DEBUG: Token trovato: '%.*s'\n", (int)token.length, &input[start]);
         
-        if (strcasecmp(token.value, "true") == 0) {
-            printf("DEBUG: Riconosciuto come TRUE\n");
-            token.type = TOKEN_BOOLEAN;
-            token.number = 1.0;
-            return token;
-        } else if (strcasecmp(token.value, "false") == 0) {
-            printf("DEBUG: Riconosciuto come FALSE\n");
-            token.type = TOKEN_BOOLEAN;
-            token.number = 0.0;
-            return token;
-        } else if (strcasecmp(token.value, "AND") == 0 || strcasecmp(token.value, "OR") == 0 || 
-                strcasecmp(token.value, "XOR") == 0 || strcasecmp(token.value, "NOT") == 0) {
-            printf("DEBUG: Riconosciuto come OPERATORE LOGICO\n");
-            token.type = TOKEN_OPERATOR;
-        } else {
-            printf("DEBUG: Riconosciuto come VARIABILE\n");
-            token.type = TOKEN_VARIABLE;
+        switch (lookup_keyword(&input[start], token.length)) {
+            case KW_TRUE:
+                TRACE(TRACE_TOKENS, "DEBUG: Riconosciuto come TRUE\n");
+                token.type = TOKEN_BOOLEAN;
+                token.number = 1.0;
+                return token;
+            case KW_FALSE:
+                TRACE(TRACE_TOKENS, "DEBUG: Riconosciuto come FALSE\n");
+                token.type = TOKEN_BOOLEAN;
+                token.number = 0.0;
+                return token;
+            case KW_AND: token.op = OPERATOR_AND; break;
+            case KW_OR: token.op = OPERATOR_OR; break;
+            case KW_XOR: token.op = OPERATOR_XOR; break;
+            case KW_NOT: token.op = OPERATOR_NOT; break;
+            default:
+                TRACE(TRACE_TOKENS, "DEBUG: Riconosciuto come VARIABILE\n");
+                return token;
         }
+        TRACE(TRACE_TOKENS, "DEBUG: Riconosciuto come OPERATORE LOGICO\n");
+        token.type = TOKEN_OPERATOR;
         return token;
     }
     
     // Token non riconosciuto
     tokenizer->pos++;
 
-    return token;
+    return make_token(tokenizer, TOKEN_ERROR, start);
 }
 
-// Converte risultati a tipo comune per operazioni
-CalcResult convert_to_common_type(CalcResult a, CalcResult b) {
-    CalcResult result = {TYPE_INT, {0}};
-    
-    if (a.type == TYPE_FLOAT || b.type == TYPE_FLOAT) {
-        result.type = TYPE_FLOAT;
-        result.value.f_val = (a.type == TYPE_FLOAT ? a.value.f_val : (float)a.value.i_val) +
-                           (b.type == TYPE_FLOAT ? b.value.f_val : (float)b.value.i_val);
-    } else {
-        result.type = TYPE_INT;
-        result.value.i_val = a.value.i_val + b.value.i_val;
-    }
-    
+// -------------------------- ARITMETICA --------------------------
+// Gli interi sono a 64 bit con controllo dell'overflow, i float sono double.
+// Ogni operatore binario ha un kernel per ogni coppia di tipi (INT/FLOAT): apply_binary_operator
+// lo sceglie con un solo accesso alla matrice, senza ricontrollare i tipi in ogni ramo.
+
+#define CALC_TYPES (TYPE_FLOAT + 1) // i BOOL vengono promossi a INT prima della scelta del kernel
+
+typedef CalcResult (*BinaryKernel)(Interpreter *interp, CalcResult left, CalcResult right, int line_number);
+
+static CalcResult make_int(int64_t value) {
+    CalcResult result = {TYPE_INT, {.i_val = value}};
     return result;
 }
 
-// Applica operatori binari
-CalcResult apply_binary_operator(const char *op, CalcResult left, CalcResult right, int line_number) {
-    CalcResult result = {TYPE_INT, {0}};
-    
-    // Operatori aritmetici
-    if (strcmp(op, "+") == 0) {
-        if (left.type == TYPE_FLOAT || right.type == TYPE_FLOAT) {
-            result.type = TYPE_FLOAT;
-            result.value.f_val = (left.type == TYPE_FLOAT ? left.value.f_val : (float)left.value.i_val) +
-                               (right.type == TYPE_FLOAT ? right.value.f_val : (float)right.value.i_val);
-        } else {
-            result.type = TYPE_INT;
-            result.value.i_val = left.value.i_val + right.value.i_val;
-        }
-    }
-    else if (strcmp(op, "-") == 0) {
-        if (left.type == TYPE_FLOAT || right.type == TYPE_FLOAT) {
-            result.type = TYPE_FLOAT;
-            result.value.f_val = (left.type == TYPE_FLOAT ? left.value.f_val : (float)left.value.i_val) -
-                               (right.type == TYPE_FLOAT ? right.value.f_val : (float)right.value.i_val);
-        } else {
-            result.type = TYPE_INT;
-            result.value.i_val = left.value.i_val - right.value.i_val;
-        }
-    }
-    else if (strcmp(op, "*") == 0) {
-        if (left.type == TYPE_FLOAT || right.type == TYPE_FLOAT) {
-            result.type = TYPE_FLOAT;
-            result.value.f_val = (left.type == TYPE_FLOAT ? left.value.f_val : (float)left.value.i_val) *
-                               (right.type == TYPE_FLOAT ? right.value.f_val : (float)right.value.i_val);
-        } else {
-            result.type = TYPE_INT;
-            result.value.i_val = left.value.i_val * right.value.i_val;
-        }
-    }
-    else if (strcmp(op, "/") == 0) {
-        double right_val = (right.type == TYPE_FLOAT ? right.value.f_val : (double)right.value.i_val);
-        if (right_val == 0.0) {
-            handle_error("DIVISION BY ZERO", line_number);
-        }
-        result.type = TYPE_FLOAT;
-        result.value.f_val = (left.type == TYPE_FLOAT ? left.value.f_val : (float)left.value.i_val) / right_val;
-    }
-    else if (strcmp(op, "%") == 0) {
-        if (left.type != TYPE_INT || right.type != TYPE_INT) {
-            handle_error("MODULO OPERATOR REQUIRES INTEGER OPERANDS", line_number);
-        }
-        if (right.value.i_val == 0) {
-            handle_error("MODULO BY ZERO", line_number);
-        }
-        result.type = TYPE_INT;
-        result.value.i_val = left.value.i_val % right.value.i_val;
-    }
-    else if (strcmp(op, "**") == 0) {
-        result.type = TYPE_FLOAT;
-        double base = (left.type == TYPE_FLOAT ? left.value.f_val : (double)left.value.i_val);
-        double exp = (right.type == TYPE_FLOAT ? right.value.f_val : (double)right.value.i_val);
-        result.value.f_val = pow(base, exp);
-    }
-    else if (strcmp(op, "***") == 0) {
-        result.type = TYPE_FLOAT;
-        double base = (left.type == TYPE_FLOAT ? left.value.f_val : (double)left.value.i_val);
-        double exp = (right.type == TYPE_FLOAT ? right.value.f_val : (double)right.value.i_val);
-        if (base < 0 && exp != floor(exp)) {
-            handle_error("NEGATIVE BASE WITH NON-INTEGER EXPONENT", line_number);
-        }
-        result.value.f_val = pow(base, exp);
-    }
-    // Operatori relazionali
-    else if (strcmp(op, "==") == 0) {
-        result.type = TYPE_BOOL;
-        if (left.type == TYPE_FLOAT || right.type == TYPE_FLOAT) {
-            double left_val = (left.type == TYPE_FLOAT ? left.value.f_val : (double)left.value.i_val);
-            double right_val = (right.type == TYPE_FLOAT ? right.value.f_val : (double)right.value.i_val);
-            result.value.b_val = (left_val == right_val);
-        } else {
-            result.value.b_val = (left.value.i_val == right.value.i_val);
-        }
-    }
-    else if (strcmp(op, "!=") == 0) {
-        result.type = TYPE_BOOL;
-        if (left.type == TYPE_FLOAT || right.type == TYPE_FLOAT) {
-            double left_val = (left.type == TYPE_FLOAT ? left.value.f_val : (double)left.value.i_val);
-            double right_val = (right.type == TYPE_FLOAT ? right.value.f_val : (double)right.value.i_val);
-            result.value.b_val = (left_val != right_val);
-        } else {
-            result.value.b_val = (left.value.i_val != right.value.i_val);
-        }
-    }
-    else if (strcmp(op, "<") == 0) {
-        result.type = TYPE_BOOL;
-        if (left.type == TYPE_FLOAT || right.type == TYPE_FLOAT) {
-            double left_val = (left.type == TYPE_FLOAT ? left.value.f_val : (double)left.value.i_val);
-            double right_val = (right.type == TYPE_FLOAT ? right.value.f_val : (double)right.value.i_val);
-            result.value.b_val = (left_val < right_val);
-        } else {
-            result.value.b_val = (left.value.i_val < right.value.i_val);
-        }
-    }
-    else if (strcmp(op, ">") == 0) {
-        result.type = TYPE_BOOL;
-        if (left.type == TYPE_FLOAT || right.type == TYPE_FLOAT) {
-            double left_val = (left.type == TYPE_FLOAT ? left.value.f_val : (double)left.value.i_val);
-            double right_val = (right.type == TYPE_FLOAT ? right.value.f_val : (double)right.value.i_val);
-            result.value.b_val = (left_val > right_val);
-        } else {
-            result.value.b_val = (left.value.i_val > right.value.i_val);
-        }
-    }
-    else if (strcmp(op, "<=") == 0) {
-        result.type = TYPE_BOOL;
-        if (left.type == TYPE_FLOAT || right.type == TYPE_FLOAT) {
-            double left_val = (left.type == TYPE_FLOAT ? left.value.f_val : (double)left.value.i_val);
-            double right_val = (right.type == TYPE_FLOAT ? right.value.f_val : (double)right.value.i_val);
-            result.value.b_val = (left_val <= right_val);
-        } else {
-            result.value.b_val = (left.value.i_val <= right.value.i_val);
-        }
-    }
-    else if (strcmp(op, ">=") == 0) {
-        result.type = TYPE_BOOL;
-        if (left.type == TYPE_FLOAT || right.type == TYPE_FLOAT) {
-            double left_val = (left.type == TYPE_FLOAT ? left.value.f_val : (double)left.value.i_val);
-            double right_val = (right.type == TYPE_FLOAT ? right.value.f_val : (double)right.value.i_val);
-            result.value.b_val = (left_val >= right_val);
-        } else {
-            result.value.b_val = (left.value.i_val >= right.value.i_val);
-        }
-    }
-    // Operatori logici
-    else if (strcasecmp(op, "AND") == 0) {
-        result.type = TYPE_BOOL;
-        bool left_bool = (left.type == TYPE_BOOL) ? left.value.b_val : 
-                        (left.type == TYPE_INT) ? (left.value.i_val != 0) : (left.value.f_val != 0.0);
-        bool right_bool = (right.type == TYPE_BOOL) ? right.value.b_val : 
-                         (right.type == TYPE_INT) ? (right.value.i_val != 0) : (right.value.f_val != 0.0);
-        result.value.b_val = left_bool && right_bool;
+static CalcResult make_float(double value) {
+    CalcResult result = {TYPE_FLOAT, {.f_val = value}};
+    return result;
+}
+
+static CalcResult make_bool(bool value) {
+    CalcResult result = {TYPE_BOOL, {.b_val = value}};
+    return result;
+}
+
+// Valore di verità di un risultato (0 e 0.0 sono falsi)
+static bool to_bool(CalcResult value) {
+    return (value.type == TYPE_BOOL) ? value.value.b_val :
+           (value.type == TYPE_INT) ? (value.value.i_val != 0) : (value.value.f_val != 0.0);
+}
+
+// Potenza intera esatta per moltiplicazioni successive; false se esce dai 64 bit
+static bool int_pow(int64_t base, int64_t exp, int64_t *out) {
+    int64_t result = 1;
+    while (exp > 0) {
+        if ((exp & 1) && __builtin_mul_overflow(result, base, &result)) return false;
+        exp >>= 1;
+        if (exp > 0 && __builtin_mul_overflow(base, base, &base)) return false;
+    }
+    *out = result;
+    return true;
+}
+
+// Kernel per INT/INT, FLOAT/FLOAT e i due casi misti (promossi a double); interp e line_number
+// servono solo ai kernel che possono sollevare un errore
+#define FLOAT_KERNELS(name, result)                                                                  \
+    static CalcResult name##_ff(Interpreter *interp, CalcResult left, CalcResult right, int line_number) { \
+        double l = left.value.f_val, r = right.value.f_val;                                          \
+        (void)interp, (void)line_number;                                                             \
+        return result;                                                                               \
+    }                                                                                                \
+    static CalcResult name##_if(Interpreter *interp, CalcResult left, CalcResult right, int line_number) { \
+        double l = (double)left.value.i_val, r = right.value.f_val;                                  \
+        (void)interp, (void)line_number;                                                             \
+        return result;                                                                               \
+    }                                                                                                \
+    static CalcResult name##_fi(Interpreter *interp, CalcResult left, CalcResult right, int line_number) { \
+        double l = left.value.f_val, r = (double)right.value.i_val;                                  \
+        (void)interp, (void)line_number;                                                             \
+        return result;                                                                               \
     }
-    else if (strcasecmp(op, "OR") == 0) {
-        result.type = TYPE_BOOL;
-        bool left_bool = (left.type == TYPE_BOOL) ? left.value.b_val : 
-                        (left.type == TYPE_INT) ? (left.value.i_val != 0) : (left.value.f_val != 0.0);
-        bool right_bool = (right.type == TYPE_BOOL) ? right.value.b_val : 
-                         (right.type == TYPE_INT) ? (right.value.i_val != 0) : (right.value.f_val != 0.0);
-        result.value.b_val = left_bool || right_bool;
+
+#define INT_KERNEL(name, result)                                                                     \
+    static CalcResult name##_ii(Interpreter *interp, CalcResult left, CalcResult right, int line_number) { \
+        int64_t l = left.value.i_val, r = right.value.i_val;                                         \
+        (void)interp, (void)line_number;                                                             \
+        return result;                                                                               \
     }
-    else if (strcasecmp(op, "XOR") == 0) {
-        result.type = TYPE_BOOL;
-        bool left_bool = (left.type == TYPE_BOOL) ? left.value.b_val : 
-                        (left.type == TYPE_INT) ? (left.value.i_val != 0) : (left.value.f_val != 0.0);
-        bool right_bool = (right.type == TYPE_BOOL) ? right.value.b_val : 
-                         (right.type == TYPE_INT) ? (right.value.i_val != 0) : (right.value.f_val != 0.0);
-        result.value.b_val = left_bool != right_bool;
+
+static CalcResult int_overflow(Interpreter *interp, int line_number) {
+    handle_error(interp, "INTEGER OVERFLOW. ", line_number);
+    return make_int(0);
+}
+
+// Potenza tra interi: esatta e INT con esponente non negativo (errore se esce dai 64 bit), FLOAT con pow() altrimenti
+static CalcResult power_int(Interpreter *interp, int64_t l, int64_t r, int line_number) {
+    int64_t out;
+    if (r < 0) return make_float(pow((double)l, (double)r));
+    return int_pow(l, r, &out) ? make_int(out) : int_overflow(interp, line_number);
+}
+
+static CalcResult safe_power(Interpreter *interp, double l, double r, int line_number) {
+    if (l < 0 && r != floor(r)) handle_error(interp, "NEGATIVE BASE WITH NON-INTEGER EXPONENT", line_number);
+    return make_float(pow(l, r));
+}
+
+INT_KERNEL(add, make_int(calc_add_int(interp, l, r, line_number)))
+INT_KERNEL(sub, make_int(calc_sub_int(interp, l, r, line_number)))
+INT_KERNEL(mul, make_int(calc_mul_int(interp, l, r, line_number)))
+INT_KERNEL(div, make_float(calc_div_int(interp, l, r, line_number)))
+INT_KERNEL(mod, make_int(calc_mod_int(interp, l, r, line_number)))
+INT_KERNEL(pow, power_int(interp, l, r, line_number))
+INT_KERNEL(safe_pow, power_int(interp, l, r, line_number))
+INT_KERNEL(eq, make_bool(l == r))
+INT_KERNEL(ne, make_bool(l != r))
+INT_KERNEL(lt, make_bool(l < r))
+INT_KERNEL(gt, make_bool(l > r))
+INT_KERNEL(le, make_bool(l <= r))
+INT_KERNEL(ge, make_bool(l >= r))
+
+FLOAT_KERNELS(add, make_float(l + r))
+FLOAT_KERNELS(sub, make_float(l - r))
+FLOAT_KERNELS(mul, make_float(l * r))
+FLOAT_KERNELS(div, make_float(calc_div_float(interp, l, r, line_number)))
+FLOAT_KERNELS(pow, make_float(pow(l, r)))
+FLOAT_KERNELS(safe_pow, safe_power(interp, l, r, line_number))
+FLOAT_KERNELS(eq, make_bool(l == r))
+FLOAT_KERNELS(ne, make_bool(l != r))
+FLOAT_KERNELS(lt, make_bool(l < r))
+FLOAT_KERNELS(gt, make_bool(l > r))
+FLOAT_KERNELS(le, make_bool(l <= r))
+FLOAT_KERNELS(ge, make_bool(l >= r))
+
+static CalcResult mod_float(Interpreter *interp, CalcResult left, CalcResult right, int line_number) {
+    (void)left, (void)right;
+    handle_error(interp, "MODULO OPERATOR REQUIRES INTEGER OPERANDS", line_number);
+    return make_int(0);
+}
+
+static CalcResult and_any(Interpreter *interp, CalcResult left, CalcResult right, int line_number) {
+    (void)interp, (void)line_number;
+    return make_bool(to_bool(left) && to_bool(right));
+}
+
+static CalcResult or_any(Interpreter *interp, CalcResult left, CalcResult right, int line_number) {
+    (void)interp, (void)line_number;
+    return make_bool(to_bool(left) || to_bool(right));
+}
+
+static CalcResult xor_any(Interpreter *interp, CalcResult left, CalcResult right, int line_number) {
+    (void)interp, (void)line_number;
+    return make_bool(to_bool(left) != to_bool(right));
+}
+
+// Riga della matrice per un operatore numerico, indicizzata da [tipo sinistro][tipo destro]
+#define NUMERIC_ROW(ii, if_kernel, fi_kernel, ff_kernel) {                   \
+        [TYPE_INT]   = {[TYPE_INT] = ii, [TYPE_FLOAT] = if_kernel},            \
+        [TYPE_FLOAT] = {[TYPE_INT] = fi_kernel, [TYPE_FLOAT] = ff_kernel},     \
     }
-    else {
-        handle_error("UNKNOWN BINARY OPERATOR", line_number);
+#define ARITHMETIC_ROW(name) NUMERIC_ROW(name##_ii, name##_if, name##_fi, name##_ff)
+#define LOGICAL_ROW(kernel) NUMERIC_ROW(kernel, kernel, kernel, kernel)
+
+// Matrice (operatore, tipo sinistro, tipo destro) -> kernel
+static const BinaryKernel binary_kernels[OPERATOR_NOT + 1][CALC_TYPES][CALC_TYPES] = {
+    [OPERATOR_ADD]      = ARITHMETIC_ROW(add),
+    [OPERATOR_SUB]      = ARITHMETIC_ROW(sub),
+    [OPERATOR_MUL]      = ARITHMETIC_ROW(mul),
+    [OPERATOR_DIV]      = ARITHMETIC_ROW(div),
+    [OPERATOR_MOD]      = NUMERIC_ROW(mod_ii, mod_float, mod_float, mod_float),
+    [OPERATOR_POW]      = ARITHMETIC_ROW(pow),
+    [OPERATOR_SAFE_POW] = ARITHMETIC_ROW(safe_pow),
+    [OPERATOR_EQ]       = ARITHMETIC_ROW(eq),
+    [OPERATOR_NE]       = ARITHMETIC_ROW(ne),
+    [OPERATOR_LT]       = ARITHMETIC_ROW(lt),
+    [OPERATOR_GT]       = ARITHMETIC_ROW(gt),
+    [OPERATOR_LE]       = ARITHMETIC_ROW(le),
+    [OPERATOR_GE]       = ARITHMETIC_ROW(ge),
+    [OPERATOR_AND]      = LOGICAL_ROW(and_any),
+    [OPERATOR_OR]       = LOGICAL_ROW(or_any),
+    [OPERATOR_XOR]      = LOGICAL_ROW(xor_any),
+};
+
+// Applica operatori binari
+CalcResult apply_binary_operator(Interpreter *interp, OperatorKind op, CalcResult left, CalcResult right, int line_number) {
+    // Nelle operazioni numeriche un BOOL vale 0 o 1 (per quelle logiche non cambia nulla)
+    if (left.type == TYPE_BOOL || right.type == TYPE_BOOL) {
+        if (op == OPERATOR_MOD) handle_error(interp, "MODULO OPERATOR REQUIRES INTEGER OPERANDS", line_number);
+        if (left.type == TYPE_BOOL) left = make_int(left.value.b_val);
+        if (right.type == TYPE_BOOL) right = make_int(right.value.b_val);
     }
-    
-    return result;
+
+    BinaryKernel kernel = NULL;
+    if ((unsigned)op <= OPERATOR_NOT && (unsigned)left.type < CALC_TYPES && (unsigned)right.type < CALC_TYPES)
+        kernel = binary_kernels[op][left.type][right.type];
+    if (!kernel) {
+        handle_error(interp, "UNKNOWN BINARY OPERATOR", line_number);
+        return make_int(0);
+    }
+    return kernel(interp, left, right, line_number);
 }
 
 // Applica operatori unari
-CalcResult apply_unary_operator(const char *op, CalcResult operand, int line_number) {
+CalcResult apply_unary_operator(Interpreter *interp, OperatorKind op, CalcResult operand, int line_number) {
     CalcResult result = operand;
     
-    if (strcmp(op, "-") == 0) {
-        if (operand.type == TYPE_INT) {
-            result.value.i_val = -operand.value.i_val;
-        } else if (operand.type == TYPE_FLOAT) {
-            result.value.f_val = -operand.value.f_val;
-        } else {
-            handle_error("UNARY MINUS REQUIRES NUMERIC OPERAND", line_number);
-        }
-    }
-    else if (strcmp(op, "+") == 0) {
-        if (operand.type != TYPE_INT && operand.type != TYPE_FLOAT) {
-            handle_error("UNARY PLUS REQUIRES NUMERIC OPERAND", line_number);
-        }
-    }
-    else if (strcasecmp(op, "NOT") == 0) {
-        result.type = TYPE_BOOL;
-        bool operand_bool = (operand.type == TYPE_BOOL) ? operand.value.b_val : 
-                           (operand.type == TYPE_INT) ? (operand.value.i_val != 0) : (operand.value.f_val != 0.0);
-        result.value.b_val = !operand_bool;
-    }
-    else {
-        handle_error("UNKNOWN UNARY OPERATOR", line_number);
+    switch (op) {
+        case OPERATOR_SUB:
+            if (operand.type == TYPE_INT) {
+                result.value.i_val = calc_neg_int(interp, operand.value.i_val, line_number);
+            } else if (operand.type == TYPE_FLOAT) {
+                result.value.f_val = -operand.value.f_val;
+            } else {
+                handle_error(interp, "UNARY MINUS REQUIRES NUMERIC OPERAND", line_number);
+            }
+            break;
+        case OPERATOR_ADD:
+            if (operand.type != TYPE_INT && operand.type != TYPE_FLOAT) {
+                handle_error(interp, "UNARY PLUS REQUIRES NUMERIC OPERAND", line_number);
+            }
+            break;
+        case OPERATOR_NOT:
+            result.type = TYPE_BOOL;
+            result.value.b_val = !to_bool(operand);
+            break;
+        default:
+            handle_error(interp, "UNKNOWN UNARY OPERATOR", line_number);
+            break;
     }
     
     return result;
 }
 
+// -------------------------- COMPILAZIONE IN RPN --------------------------
+
+// Inizializza un buffer di codice RPN vuoto
+void init_expr_code(ExprCode *code) {
+    code->ops = NULL;
+    code->count = 0;
+    code->capacity = 0;
+}
+
+void free_expr_code(ExprCode *code) {
+    free(code->ops);
+    init_expr_code(code);
+}
+
+// Registra il primo errore: il parser risale senza emettere altro
+static void parser_error(ExprParser *parser, const char *message) {
+    if (!parser->error) parser->error = message;
+}
+
+// Accoda un'operazione RPN tenendo traccia della profondità della pila di valutazione
+static void emit_op(ExprParser *parser, ExprOpType type, OperatorKind op, int slot, CalcResult value) {
+    ExprCode *code = parser->code;
+    if (code->count == code->capacity) {
+        size_t capacity = code->capacity ? code->capacity * 2 : 64;
+        ExprOp *ops = realloc(code->ops, capacity * sizeof(ExprOp));
+        if (!ops) handle_error(NULL, "OUT OF MEMORY. ", -1);
+        code->ops = ops;
+        code->capacity = capacity;
+    }
+
+    ExprOp *out = &code->ops[code->count++];
+    out->type = type;
+    out->op = op;
+    out->slot = slot;
+    out->value = value;
+
+    if (type == EXPR_CONSTANT || type == EXPR_VARIABLE) parser->depth++;
+    else if (type == EXPR_BINARY) parser->depth--;
+    if (parser->depth > EXPR_STACK_SIZE) parser_error(parser, "EXPRESSION TOO COMPLEX");
+}
+
 // Parser per espressioni primarie (numeri, variabili, parentesi)
-CalcResult parse_primary_expression(Tokenizer *tokenizer, int line_number) {
-    CalcResult result = {TYPE_INT, {0}};
-    Token token = get_next_token(tokenizer);
+void parse_primary_expression(ExprParser *parser) {
+    CalcResult value = {TYPE_INT, {0}};
+    Tokenizer *tokenizer = &parser->tokenizer;
+    Token token = next_token(tokenizer);
     
     if (token.type == TOKEN_NUMBER) {
-        if (strchr(token.value, '.') != NULL) {
-            result.type = TYPE_FLOAT;
-            result.value.f_val = (float)token.number;
+        if (token.is_float) {
+            value.type = TYPE_FLOAT;
+            value.value.f_val = token.number;
+        } else if (token.overflow) {
+            parser_error(parser, "INTEGER LITERAL OUT OF RANGE");
+            return;
         } else {
-            result.type = TYPE_INT;
-            result.value.i_val = (int)token.number;
+            value.type = TYPE_INT;
+            value.value.i_val = token.integer;
         }
-        return result;
+        emit_op(parser, EXPR_CONSTANT, OPERATOR_NONE, -1, value);
+        return;
     }
 
     if (token.type == TOKEN_BOOLEAN) {
-        result.type = TYPE_BOOL;
-        result.value.b_val = (token.number != 0.0);
-        return result;
+        value.type = TYPE_BOOL;
+        value.value.b_val = (token.number != 0.0);
+        emit_op(parser, EXPR_CONSTANT, OPERATOR_NONE, -1, value);
+        return;
     }
 
+    // Il riferimento viene risolto a uno slot adesso; il valore si legge a ogni valutazione
     if (token.type == TOKEN_VARIABLE) {
-        Variable *var = find_variable(token.value);
-        if (!var) {
-            handle_error("VARIABLE NOT FOUND IN EXPRESSION", line_number);
-        }
-        
-        result.type = var->type;
-        switch (var->type) {
-            case TYPE_INT:
-                result.value.i_val = var->value.i_val;
-                break;
-            case TYPE_FLOAT:
-                result.value.f_val = var->value.f_val;
-                break;
-            case TYPE_BOOL:
-                result.value.b_val = var->value.b_val;
-                break;
-            default:
-                handle_error("UNSUPPORTED VARIABLE TYPE IN EXPRESSION", line_number);
-        }
-        return result;
+        int slot = intern_variable_len(parser->interp, &tokenizer->input[token.start], token.length);
+        emit_op(parser, EXPR_VARIABLE, OPERATOR_NONE, slot, value);
+        return;
     }
     
     if (token.type == TOKEN_LPAREN) {
-        result = parse_expression(tokenizer, line_number);
-        token = get_next_token(tokenizer);
-        if (token.type != TOKEN_RPAREN) {
-            handle_error("MISSING CLOSING PARENTHESIS", line_number);
+        parse_expression(parser);
+        if (parser->error) return;
+        if (next_token(tokenizer).type != TOKEN_RPAREN) {
+            parser_error(parser, "MISSING CLOSING PARENTHESIS");
         }
-        return result;
+        return;
     }
     
-    handle_error("INVALID PRIMARY EXPRESSION", line_number);
-    return result;
+    parser_error(parser, "INVALID PRIMARY EXPRESSION");
 }
 
-// Parser per espressioni unarie
-CalcResult parse_unary_expression(Tokenizer *tokenizer, int line_number) {
-    Token token = get_next_token(tokenizer);
-    
-    if (token.type == TOKEN_OPERATOR && 
-        (strcmp(token.value, "-") == 0 || strcmp(token.value, "+") == 0 || strcasecmp(token.value, "NOT") == 0)) {
-        CalcResult operand = parse_unary_expression(tokenizer, line_number);
-        return apply_unary_operator(token.value, operand, line_number);
-    } else {
-        // Rimetti il token indietro
-        if (token.type != TOKEN_END) {
-            if (token.type == TOKEN_OPERATOR || 
-                token.type == TOKEN_NUMBER || 
-                token.type == TOKEN_VARIABLE || 
-                token.type == TOKEN_BOOLEAN) {
-                tokenizer->pos -= strlen(token.value);
-            } else {
-                tokenizer->pos--;
-            }
-        }
-        return parse_primary_expression(tokenizer, line_number);
-    }
+// Parser per espressioni unarie: gli operatori prefissi legano più di qualsiasi operatore binario
+void parse_unary_expression(ExprParser *parser) {
+    const Token *token = peek_token(&parser->tokenizer);
+    
+    if (token->type == TOKEN_OPERATOR && operator_table[token->op].is_prefix) {
+        OperatorKind op = next_token(&parser->tokenizer).op;
+        CalcResult none = {TYPE_INT, {0}};
+        parse_unary_expression(parser);
+        if (parser->error) return;
+        emit_op(parser, EXPR_UNARY, op, -1, none);
+        return;
+    }
+    parse_primary_expression(parser);
 }
 
-// Parser per espressioni di potenza
-CalcResult parse_power_expression(Tokenizer *tokenizer, int line_number) {
-    CalcResult left = parse_unary_expression(tokenizer, line_number);
+// Precedence climbing: consuma operatori binari con precedenza >= min_precedence (tutti associativi a sinistra)
+void parse_binary_expression(ExprParser *parser, int min_precedence) {
+    parse_unary_expression(parser);
     
-    Token token = get_next_token(tokenizer);
-    while (token.type == TOKEN_OPERATOR && 
-           (strcmp(token.value, "**") == 0 || strcmp(token.value, "***") == 0)) {
-        CalcResult right = parse_unary_expression(tokenizer, line_number);
-        left = apply_binary_operator(token.value, left, right, line_number);
-        token = get_next_token(tokenizer);
-    }
-    
-    // Rimetti l'ultimo token indietro
-        if (token.type != TOKEN_END) {
-            if (token.type == TOKEN_OPERATOR || 
-                token.type == TOKEN_NUMBER || 
-                token.type == TOKEN_VARIABLE || 
-                token.type == TOKEN_BOOLEAN) {
-                tokenizer->pos -= strlen(token.value);
-            } else {
-                tokenizer->pos--;
-            }
-        }
-    
-    return left;
-}
+    while (!parser->error) {
+        const Token *token = peek_token(&parser->tokenizer);
+        if (token->type != TOKEN_OPERATOR) break;
 
-// Parser per espressioni moltiplicative
-CalcResult parse_multiplicative_expression(Tokenizer *tokenizer, int line_number) {
-    CalcResult left = parse_power_expression(tokenizer, line_number);
-    
-    Token token = get_next_token(tokenizer);
-    while (token.type == TOKEN_OPERATOR && 
-           (strcmp(token.value, "*") == 0 || strcmp(token.value, "/") == 0 || strcmp(token.value, "%") == 0)) {
-        CalcResult right = parse_power_expression(tokenizer, line_number);
-        left = apply_binary_operator(token.value, left, right, line_number);
-        token = get_next_token(tokenizer);
-    }
-    
-    // Rimetti l'ultimo token indietro
-        if (token.type != TOKEN_END) {
-            if (token.type == TOKEN_OPERATOR || 
-                token.type == TOKEN_NUMBER || 
-                token.type == TOKEN_VARIABLE || 
-                token.type == TOKEN_BOOLEAN) {
-                tokenizer->pos -= strlen(token.value);
-            } else {
-                tokenizer->pos--;
-            }
-        }
-    
-    return left;
-}
+        int precedence = operator_table[token->op].precedence;
+        if (precedence == 0 || precedence < min_precedence) break;
 
-// Parser per espressioni additive
-CalcResult parse_additive_expression(Tokenizer *tokenizer, int line_number) {
-    CalcResult left = parse_multiplicative_expression(tokenizer, line_number);
-    
-    Token token = get_next_token(tokenizer);
-    while (token.type == TOKEN_OPERATOR && 
-           (strcmp(token.value, "+") == 0 || strcmp(token.value, "-") == 0)) {
-        CalcResult right = parse_multiplicative_expression(tokenizer, line_number);
-        left = apply_binary_operator(token.value, left, right, line_number);
-        token = get_next_token(tokenizer);
+        OperatorKind op = next_token(&parser->tokenizer).op;
+        CalcResult none = {TYPE_INT, {0}};
+        parse_binary_expression(parser, precedence + 1);
+        if (parser->error) return;
+        emit_op(parser, EXPR_BINARY, op, -1, none);
     }
-    
-    // Rimetti l'ultimo token indietro
-        if (token.type != TOKEN_END) {
-            if (token.type == TOKEN_OPERATOR || 
-                token.type == TOKEN_NUMBER || 
-                token.type == TOKEN_VARIABLE || 
-                token.type == TOKEN_BOOLEAN) {
-                tokenizer->pos -= strlen(token.value);
-            } else {
-                tokenizer->pos--;
-            }
-        }
-    
-    return left;
 }
 
-// Parser per espressioni relazionali
-CalcResult parse_relational_expression(Tokenizer *tokenizer, int line_number) {
-    CalcResult left = parse_additive_expression(tokenizer, line_number);
-    
-    Token token = get_next_token(tokenizer);
-    while (token.type == TOKEN_OPERATOR && 
-           (strcmp(token.value, "<") == 0 || strcmp(token.value, ">") == 0 || 
-            strcmp(token.value, "<=") == 0 || strcmp(token.value, ">=") == 0)) {
-        CalcResult right = parse_additive_expression(tokenizer, line_number);
-        left = apply_binary_operator(token.value, left, right, line_number);
-        token = get_next_token(tokenizer);
-    }
-    
-    // Rimetti l'ultimo token indietro
-        if (token.type != TOKEN_END) {
-            if (token.type == TOKEN_OPERATOR || 
-                token.type == TOKEN_NUMBER || 
-                token.type == TOKEN_VARIABLE || 
-                token.type == TOKEN_BOOLEAN) {
-                tokenizer->pos -= strlen(token.value);
-            } else {
-                tokenizer->pos--;
-            }
-        }
-    
-    return left;
+// Parser principale per espressioni
+void parse_expression(ExprParser *parser) {
+    parse_binary_expression(parser, 1);
 }
 
-// Parser per espressioni di uguaglianza
-CalcResult parse_equality_expression(Tokenizer *tokenizer, int line_number) {
-    CalcResult left = parse_relational_expression(tokenizer, line_number);
+// Compila l'espressione in coda a code; restituisce NULL oppure il messaggio d'errore
+const char *compile_expression(Interpreter *interp, const char *expression, ExprCode *code) {
+    ExprParser parser;
+    init_tokenizer(&parser.tokenizer, expression);
+    parser.interp = interp;
+    parser.code = code;
+    parser.error = NULL;
+    parser.depth = 0;
+
+    size_t start = code->count;
+    parse_expression(&parser);
     
-    Token token = get_next_token(tokenizer);
-    while (token.type == TOKEN_OPERATOR && 
-           (strcmp(token.value, "==") == 0 || strcmp(token.value, "!=") == 0)) {
-        CalcResult right = parse_relational_expression(tokenizer, line_number);
-        left = apply_binary_operator(token.value, left, right, line_number);
-        token = get_next_token(tokenizer);
+    // Verifica che l'espressione sia completamente consumata
+    if (!parser.error && next_token(&parser.tokenizer).type != TOKEN_END) {
+        parser_error(&parser, "UNEXPECTED TOKEN IN EXPRESSION");
     }
-    
-    // Rimetti l'ultimo token indietro
-        if (token.type != TOKEN_END) {
-            if (token.type == TOKEN_OPERATOR || 
-                token.type == TOKEN_NUMBER || 
-                token.type == TOKEN_VARIABLE || 
-                token.type == TOKEN_BOOLEAN) {
-                tokenizer->pos -= strlen(token.value);
-            } else {
-                tokenizer->pos--;
-            }
-        }
-    
-    return left;
+    if (parser.error) code->count = start; // scarta il codice parziale
+
+    return parser.error;
 }
 
-// Parser per espressioni AND
-CalcResult parse_and_expression(Tokenizer *tokenizer, int line_number) {
-    CalcResult left = parse_equality_expression(tokenizer, line_number);
-    
-    Token token = get_next_token(tokenizer);
-    while (token.type == TOKEN_OPERATOR && strcasecmp(token.value, "AND") == 0) {
-        CalcResult right = parse_equality_expression(tokenizer, line_number);
-        left = apply_binary_operator(token.value, left, right, line_number);
-        token = get_next_token(tokenizer);
+// -------------------------- VALUTAZIONE --------------------------
+
+// Testo di una variabile STR o CHAR letto come letterale (numero, anche negativo, oppure true/false):
+// lo stesso risultato di quando CALC sostituiva il testo della variabile nell'espressione. SET STR
+// conserva le virgolette, quindi "7" vale come 7
+static CalcResult parse_literal_text(Interpreter *interp, const char *text, size_t len, int line_number) {
+    CalcResult result = {TYPE_INT, {0}};
+    if (len >= 2 && text[0] == '"' && text[len - 1] == '"') {
+        text++;
+        len -= 2;
+    }
+    Tokenizer tokenizer = {.input = text, .length = len};
+    Token token = next_token(&tokenizer);
+    bool negative = token.type == TOKEN_OPERATOR && token.op == OPERATOR_SUB;
+    if (negative) token = next_token(&tokenizer);
+
+    if (token.type == TOKEN_NUMBER && token.is_float) {
+        result.type = TYPE_FLOAT;
+        result.value.f_val = negative ? -token.number : token.number;
+    } else if (token.type == TOKEN_NUMBER && !token.overflow) {
+        result.value.i_val = negative ? -token.integer : token.integer;
+    } else if (token.type == TOKEN_BOOLEAN && !negative) {
+        result.type = TYPE_BOOL;
+        result.value.b_val = token.number != 0.0;
+    } else {
+        token.type = TOKEN_ERROR;
     }
-    
-    // Rimetti l'ultimo token indietro
-        if (token.type != TOKEN_END) {
-            if (token.type == TOKEN_OPERATOR || 
-                token.type == TOKEN_NUMBER || 
-                token.type == TOKEN_VARIABLE || 
-                token.type == TOKEN_BOOLEAN) {
-                tokenizer->pos -= strlen(token.value);
-            } else {
-                tokenizer->pos--;
-            }
-        }
-    
-    return left;
+    if (token.type == TOKEN_ERROR || next_token(&tokenizer).type != TOKEN_END)
+        handle_error(interp, "STRING VARIABLE IS NOT A NUMBER IN EXPRESSION", line_number);
+    return result;
 }
 
-// Parser per espressioni XOR
-CalcResult parse_xor_expression(Tokenizer *tokenizer, int line_number) {
-    CalcResult left = parse_and_expression(tokenizer, line_number);
-    
-    Token token = get_next_token(tokenizer);
-    while (token.type == TOKEN_OPERATOR && strcasecmp(token.value, "XOR") == 0) {
-        CalcResult right = parse_and_expression(tokenizer, line_number);
-        left = apply_binary_operator(token.value, left, right, line_number);
-        token = get_next_token(tokenizer);
+// Legge il valore corrente di una variabile referenziata dall'espressione
+CalcResult load_variable(Interpreter *interp, int slot, int line_number) {
+    CalcResult result = {TYPE_INT, {0}};
+    Variable *var = &interp->stack[slot];
+    if (!var->is_declared) {
+        handle_error(interp, "VARIABLE NOT FOUND IN EXPRESSION", line_number);
+    }
+    
+    result.type = var->type;
+    switch (var->type) {
+        case TYPE_INT:
+            result.value.i_val = var->value.i_val;
+            break;
+        case TYPE_FLOAT:
+            result.value.f_val = var->value.f_val;
+            break;
+        case TYPE_BOOL:
+            result.value.b_val = var->value.b_val;
+            break;
+        case TYPE_STR:
+            return parse_literal_text(interp, string_data(&var->value.s_val), var->value.s_val.len, line_number);
+        case TYPE_CHAR:
+            return parse_literal_text(interp, &var->value.c_val, var->value.c_val ? 1 : 0, line_number);
+        default:
+            handle_error(interp, "UNSUPPORTED VARIABLE TYPE IN EXPRESSION", line_number);
     }
-    
-    // Rimetti l'ultimo token indietro
-        if (token.type != TOKEN_END) {
-            if (token.type == TOKEN_OPERATOR || 
-                token.type == TOKEN_NUMBER || 
-                token.type == TOKEN_VARIABLE || 
-                token.type == TOKEN_BOOLEAN) {
-                tokenizer->pos -= strlen(token.value);
-            } else {
-                tokenizer->pos--;
-            }
-        }
-    
-    return left;
+    return result;
 }
 
-// Parser per espressioni OR
-CalcResult parse_or_expression(Tokenizer *tokenizer, int line_number) {
-    CalcResult left = parse_xor_expression(tokenizer, line_number);
-    
-    Token token = get_next_token(tokenizer);
-    while (token.type == TOKEN_OPERATOR && strcasecmp(token.value, "OR") == 0) {
-        CalcResult right = parse_xor_expression(tokenizer, line_number);
-        left = apply_binary_operator(token.value, left, right, line_number);
-        token = get_next_token(tokenizer);
-    }
-    
-    // Rimetti l'ultimo token indietro
-        if (token.type != TOKEN_END) {
-            if (token.type == TOKEN_OPERATOR || 
-                token.type == TOKEN_NUMBER || 
-                token.type == TOKEN_VARIABLE || 
-                token.type == TOKEN_BOOLEAN) {
-                tokenizer->pos -= strlen(token.value);
-            } else {
-                tokenizer->pos--;
-            }
+// Valuta un'espressione già compilata sui valori correnti delle variabili
+CalcResult evaluate_compiled(Interpreter *interp, const ExprOp *ops, size_t count, int line_number) {
+    PROFILE_BEGIN(started);
+    CalcResult values[EXPR_STACK_SIZE];
+    int sp = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const ExprOp *op = &ops[i];
+        switch (op->type) {
+            case EXPR_CONSTANT:
+                values[sp++] = op->value;
+                break;
+            case EXPR_VARIABLE:
+                values[sp++] = load_variable(interp, op->slot, line_number);
+                break;
+            case EXPR_UNARY:
+                values[sp - 1] = apply_unary_operator(interp, op->op, values[sp - 1], line_number);
+                break;
+            case EXPR_BINARY:
+                sp--;
+                values[sp - 1] = apply_binary_operator(interp, op->op, values[sp - 1], values[sp], line_number);
+                break;
         }
-    
-    return left;
-}
+    }
 
-// Parser principale per espressioni
-CalcResult parse_expression(Tokenizer *tokenizer, int line_number) {
-    return parse_or_expression(tokenizer, line_number);
+    PROFILE_END(PROFILE_EXPRESSION, started);
+    return values[0];
 }
 
-// Funzione principale per valutare un'espressione
-CalcResult evaluate_expression(const char *expression, int line_number) {
-    Tokenizer tokenizer;
-    init_tokenizer(&tokenizer, expression);
-    
-    CalcResult result = parse_expression(&tokenizer, line_number);
-    
-    // Verifica che l'espressione sia completamente consumata
-    Token token = get_next_token(&tokenizer);
-    if (token.type != TOKEN_END) {
-        handle_error("UNEXPECTED TOKEN IN EXPRESSION", line_number);
-    }
-    
+// Funzione principale per valutare un'espressione testuale (compila e valuta subito)
+CalcResult evaluate_expression(Interpreter *interp, const char *expression, int line_number) {
+    ExprCode code;
+    init_expr_code(&code);
+
+    const char *error = compile_expression(interp, expression, &code);
+    if (error) handle_error(interp, error, line_number);
+
+    CalcResult result = evaluate_compiled(interp, code.ops, code.count, line_number);
+    free_expr_code(&code);
     return result;
 }
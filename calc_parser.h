@@ -1,8 +1,9 @@
 #ifndef CALC_PARSER_H
 #define CALC_PARSER_H
 
+#include <stdint.h>
 #include <stdbool.h>
-#include "helper_function-2_2.h"
+#include "helper_function-2.2.h"
 
 // Tipi di token per il parser
 typedef enum {
@@ -16,52 +17,155 @@ typedef enum {
     TOKEN_ERROR
 } TokenType;
 
-// Struttura per rappresentare un token
+// Operatori riconosciuti dal tokenizer
+typedef enum {
+    OPERATOR_NONE,
+    OPERATOR_ADD,       // +
+    OPERATOR_SUB,       // -
+    OPERATOR_MUL,       // *
+    OPERATOR_DIV,       // /
+    OPERATOR_MOD,       // %
+    OPERATOR_POW,       // **
+    OPERATOR_SAFE_POW,  // *** (errore con base negativa ed esponente non intero)
+    OPERATOR_EQ,        // ==
+    OPERATOR_NE,        // !=
+    OPERATOR_LT,        // <
+    OPERATOR_GT,        // >
+    OPERATOR_LE,        // <=
+    OPERATOR_GE,        // >=
+    OPERATOR_AND,
+    OPERATOR_OR,
+    OPERATOR_XOR,
+    OPERATOR_NOT
+} OperatorKind;
+
+// Struttura per rappresentare un token: uno span (offset, lunghezza) nell'input, senza copie
 typedef struct {
     TokenType type;
-    char value[256];
-    double number;
+    OperatorKind op;    // valido per TOKEN_OPERATOR
+    bool is_float;      // TOKEN_NUMBER con punto decimale
+    uint32_t start;
+    uint32_t length;
+    double number;      // valore già convertito (numeri e booleani)
+    int64_t integer;    // TOKEN_NUMBER intero, senza passare da double
+    bool overflow;      // intero fuori dai 64 bit
 } Token;
 
 // Struttura per il risultato di una valutazione
 typedef struct {
     VarType type;
     union {
-        int i_val;
-        float f_val;
+        int64_t i_val;
+        double f_val;
         bool b_val;
     } value;
 } CalcResult;
 
-// Struttura per il tokenizer
+// Regole dell'aritmetica su interi e double condivise da CALC, dalla VM e dal C generato con --emit-c:
+// stessi controlli e stessi messaggi. handle_error non ritorna (longjmp oppure exit)
+static inline int64_t calc_add_int(Interpreter *interp, int64_t l, int64_t r, int line_number) {
+    int64_t out;
+    if (__builtin_add_overflow(l, r, &out)) handle_error(interp, "INTEGER OVERFLOW. ", line_number);
+    return out;
+}
+
+static inline int64_t calc_sub_int(Interpreter *interp, int64_t l, int64_t r, int line_number) {
+    int64_t out;
+    if (__builtin_sub_overflow(l, r, &out)) handle_error(interp, "INTEGER OVERFLOW. ", line_number);
+    return out;
+}
+
+static inline int64_t calc_mul_int(Interpreter *interp, int64_t l, int64_t r, int line_number) {
+    int64_t out;
+    if (__builtin_mul_overflow(l, r, &out)) handle_error(interp, "INTEGER OVERFLOW. ", line_number);
+    return out;
+}
+
+static inline int64_t calc_neg_int(Interpreter *interp, int64_t value, int line_number) {
+    if (value == INT64_MIN) handle_error(interp, "INTEGER OVERFLOW. ", line_number);
+    return -value;
+}
+
+// La divisione dà sempre FLOAT; tra interi il quoziente esatto evita gli arrotondamenti oltre 2^53
+static inline double calc_div_int(Interpreter *interp, int64_t l, int64_t r, int line_number) {
+    if (r == 0) handle_error(interp, "DIVISION BY ZERO", line_number);
+    if (r == -1) return -(double)l;
+    return l % r == 0 ? (double)(l / r) : (double)l / (double)r;
+}
+
+static inline double calc_div_float(Interpreter *interp, double l, double r, int line_number) {
+    if (r == 0.0) handle_error(interp, "DIVISION BY ZERO", line_number);
+    return l / r;
+}
+
+static inline int64_t calc_mod_int(Interpreter *interp, int64_t l, int64_t r, int line_number) {
+    if (r == 0) handle_error(interp, "MODULO BY ZERO", line_number);
+    return r == -1 ? 0 : l % r;
+}
+
+// Struttura per il tokenizer, con un token di lookahead
 typedef struct {
     const char *input;
     size_t pos;
     size_t length;
+    Token lookahead;
+    bool has_lookahead;
 } Tokenizer;
 
+// Profondità massima della pila di valutazione di un'espressione compilata
+#define EXPR_STACK_SIZE 256
+
+// Operazioni del codice RPN di un'espressione compilata
+typedef enum {
+    EXPR_CONSTANT,  // letterale già convertito
+    EXPR_VARIABLE,  // legge lo slot di una variabile
+    EXPR_UNARY,
+    EXPR_BINARY
+} ExprOpType;
+
+typedef struct {
+    ExprOpType type;
+    OperatorKind op;    // EXPR_UNARY, EXPR_BINARY
+    int slot;           // EXPR_VARIABLE
+    CalcResult value;   // EXPR_CONSTANT
+} ExprOp;
+
+// Buffer crescente di operazioni RPN (più espressioni possono condividerlo)
+typedef struct {
+    ExprOp *ops;
+    size_t count;
+    size_t capacity;
+} ExprCode;
+
+// Stato del parser: tokenizer, codice in costruzione e primo errore incontrato
+typedef struct {
+    Tokenizer tokenizer;
+    Interpreter *interp; // contesto in cui vengono internati i nomi delle variabili
+    ExprCode *code;
+    const char *error;
+    int depth;
+} ExprParser;
+
 // Dichiarazioni delle funzioni del parser
 void init_tokenizer(Tokenizer *tokenizer, const char *input);
 Token get_next_token(Tokenizer *tokenizer);
-CalcResult evaluate_expression(const char *expression, int line_number);
-CalcResult parse_expression(Tokenizer *tokenizer, int line_number);
-CalcResult parse_or_expression(Tokenizer *tokenizer, int line_number);
-CalcResult parse_xor_expression(Tokenizer *tokenizer, int line_number);
-CalcResult parse_and_expression(Tokenizer *tokenizer, int line_number);
-CalcResult parse_equality_expression(Tokenizer *tokenizer, int line_number);
-CalcResult parse_relational_expression(Tokenizer *tokenizer, int line_number);
-CalcResult parse_additive_expression(Tokenizer *tokenizer, int line_number);
-CalcResult parse_multiplicative_expression(Tokenizer *tokenizer, int line_number);
-CalcResult parse_power_expression(Tokenizer *tokenizer, int line_number);
-CalcResult parse_unary_expression(Tokenizer *tokenizer, int line_number);
-CalcResult parse_primary_expression(Tokenizer *tokenizer, int line_number);
+const Token *peek_token(Tokenizer *tokenizer);
+Token next_token(Tokenizer *tokenizer);
+void init_expr_code(ExprCode *code);
+void free_expr_code(ExprCode *code);
+const char *compile_expression(Interpreter *interp, const char *expression, ExprCode *code);
+CalcResult load_variable(Interpreter *interp, int slot, int line_number);
+CalcResult evaluate_compiled(Interpreter *interp, const ExprOp *ops, size_t count, int line_number);
+CalcResult evaluate_expression(Interpreter *interp, const char *expression, int line_number);
+void parse_expression(ExprParser *parser);
+void parse_binary_expression(ExprParser *parser, int min_precedence);
+void parse_unary_expression(ExprParser *parser);
+void parse_primary_expression(ExprParser *parser);
 
 // Funzioni di utilità
-bool is_operator(const char *str);
-int get_operator_precedence(const char *op);
-CalcResult apply_binary_operator(const char *op, CalcResult left, CalcResult right, int line_number);
-CalcResult apply_unary_operator(const char *op, CalcResult operand, int line_number);
-CalcResult convert_to_common_type(CalcResult a, CalcResult b);
+int get_operator_precedence(OperatorKind op);
+CalcResult apply_binary_operator(Interpreter *interp, OperatorKind op, CalcResult left, CalcResult right, int line_number);
+CalcResult apply_unary_operator(Interpreter *interp, OperatorKind op, CalcResult operand, int line_number);
 void skip_whitespace(Tokenizer *tokenizer);
 bool is_alpha_or_underscore(char c);
 bool is_alnum_or_underscore(char c);
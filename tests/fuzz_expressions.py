@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+# Test differenziale delle espressioni: genera script casuali di CALC dentro un ciclo e
+# confronta stdout, stderr e codice d'uscita dell'interprete con quelli di un'altra modalità
+# (di default --jit con soglia 0, così ogni espressione passa subito dal codice nativo;
+# run_tests.py lo usa anche per il C generato da --emit-c).
+# Le variabili cambiano valore a ogni giro, quindi il codice nativo già generato incontra
+# overflow, divisioni e moduli per zero e -INT64_MIN: le uscite dalle guardie devono dare
+# lo stesso risultato di evaluate_compiled.
+#
+# Uso: python3 tests/fuzz_expressions.py [--seed N] [--count N] [--interpreter noobie]
+
+import argparse
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+INTS = ["0", "1", "-1", "2", "3", "7", "-7", "100", "-3"]
+EDGE_INTS = ["4611686018427387904", "9223372036854775807", "-9223372036854775807", "(-9223372036854775807 - 1)"]
+FLOATS = ["0.0", "1.5", "-2.25", "0.1", "3.0", "-0.0", "123456789.5", "0.5"]
+VARIABLES = [("a", "INT"), ("b", "INT"), ("c", "INT"), ("f", "FLOAT"), ("g", "FLOAT"), ("t", "BOOL"), ("u", "BOOL")]
+# '<' e '<=' solo nelle condizioni di IF: in CALC aprirebbero un commento
+COMPARISONS = ["==", "!=", ">", ">="]
+CONDITIONS = COMPARISONS + ["<", "<="]
+
+
+def atom(rng, kind):
+    names = [name for name, vtype in VARIABLES if kind == "any" or vtype == kind or (kind == "num" and vtype != "BOOL")]
+    r = rng.random()
+    if r < 0.5 and names:
+        return rng.choice(names)
+    if kind == "BOOL" or (kind == "any" and r > 0.9):
+        return rng.choice(["true", "false"])
+    if kind == "INT" or rng.random() < 0.6:
+        return rng.choice(EDGE_INTS if rng.random() < 0.1 else INTS)
+    return rng.choice(FLOATS)
+
+
+# Espressione di un tipo (INT, num = INT o FLOAT, BOOL); "any" mescola i tipi e prova anche gli errori statici
+def expression(rng, depth, kind, comparisons=COMPARISONS):
+    if depth == 0 or rng.random() < 0.25:
+        return atom(rng, kind)
+    if rng.random() < 0.02:
+        kind = "any"
+    if kind == "BOOL":
+        if rng.random() < 0.5:
+            return "(%s %s %s)" % (expression(rng, depth - 1, "num"), rng.choice(comparisons), expression(rng, depth - 1, "num"))
+        if rng.random() < 0.2:
+            return "NOT " + expression(rng, depth - 1, "BOOL")
+        return "(%s %s %s)" % (expression(rng, depth - 1, "BOOL"), rng.choice(["AND", "OR", "XOR"]),
+                               expression(rng, depth - 1, "BOOL"))
+    if rng.random() < 0.1: # "-(...)": "--" aprirebbe un commento di linea
+        return "-(%s)" % expression(rng, depth - 1, kind)
+    if kind == "INT" and rng.random() < 0.1:
+        return "(%s ** %s)" % (expression(rng, depth - 1, kind), rng.choice(["0", "1", "2", "3", "b"]))
+    if kind == "INT":
+        operators = ["+", "-", "*", "%"]
+    elif kind == "num":
+        operators = ["+", "-", "*", "/", "**"]
+    else:
+        operators = ["+", "-", "*", "/", "%", "**", "***", "AND", "OR", "XOR"] + comparisons
+    return "(%s %s %s)" % (expression(rng, depth - 1, kind), rng.choice(operators), expression(rng, depth - 1, kind))
+
+
+def generate_script(rng):
+    lines = []
+    for name, vtype in VARIABLES:
+        if vtype == "INT":
+            value = rng.choice(["0", "1", "-1", "2", "-2", "7"] if rng.random() < 0.9 else ["9223372036854775806", "-9223372036854775807"])
+        elif vtype == "FLOAT":
+            value = rng.choice(FLOATS)
+        else:
+            value = rng.choice(["true", "false"])
+        lines.append("SET %s %s %s" % (vtype, name, value))
+    lines.append("REPEAT %d DO" % rng.randint(3, 6))
+    for _ in range(3):
+        lines.append("    CALC " + expression(rng, 4, rng.choice(["INT", "INT", "num", "num", "BOOL", "BOOL", "any"])))
+    lines.append("    IF %s DO" % expression(rng, 3, "BOOL", CONDITIONS))
+    lines.append('        SAY "vero\\n"')
+    lines.append("    ENDO")
+    # i valori cambiano dopo la prima valutazione: il codice nativo deve gestire i nuovi casi
+    for name, vtype in VARIABLES:
+        if vtype != "BOOL" and rng.random() < 0.6:
+            lines.append("    %s %s" % (rng.choice(["INCREMENT", "DECREMENT"]), name))
+    lines.append("ENDO")
+    return "\n".join(lines) + "\n"
+
+
+def run(interpreter, script, options, env):
+    result = subprocess.run([interpreter, *options, script], stdin=subprocess.DEVNULL, capture_output=True,
+                            env=dict(os.environ, **env), timeout=30)
+    return result.stdout.decode("utf-8", "replace"), result.stderr.decode("utf-8", "replace"), result.returncode
+
+
+def run_jit(interpreter, script):
+    return run(interpreter, script, ("--no-cache", "--jit"), {"NOOBIE_JIT_THRESHOLD": "0"})
+
+
+# Numero di script in cui la modalità indicata (run_mode(interprete, script)) non coincide con l'interprete
+def compare(interpreter, directory, seed, count, run_mode=run_jit, label="--jit", verbose=True):
+    rng = random.Random(seed)
+    script = os.path.join(directory, "fuzz_expressions.nob")
+    failures = 0
+    for _ in range(count):
+        source = generate_script(rng)
+        with open(script, "w", encoding="utf-8") as f:
+            f.write(source)
+        expected = run(interpreter, script, ("--no-cache",), {})
+        result = run_mode(interpreter, script)
+        if result != expected:
+            failures += 1
+            if verbose and failures <= 3:
+                print("MISMATCH (%s)\n%s--- interprete\n%r\n--- ottenuto\n%r" % (label, source, expected, result))
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--count", type=int, default=500)
+    parser.add_argument("--interpreter")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as directory:
+        interpreter = args.interpreter
+        if not interpreter:
+            import run_tests
+            interpreter = run_tests.build(directory)
+        failures = compare(interpreter, directory, args.seed, args.count)
+    print("%d script, %d diversi dall'interprete" % (args.count, failures))
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
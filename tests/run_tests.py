@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+# Test di regressione: compila l'interprete ed esegue ogni tests/*.nob confrontando
+# stdout con il file .out omonimo, sia senza cache sia passando per il file .nobc.
+# Il file .err, se c'è, contiene stderr seguito da "[exit N]"; senza .err lo script
+# deve terminare con stderr vuoto e codice d'uscita 0. Con --jit ogni espressione passa
+# subito dal codice nativo; in modalità emit-c lo script viene tradotto con --emit-c,
+# compilato con libnoobie.a ed eseguito. Infine fuzz_expressions.py confronta JIT e C
+# generato con l'interprete su espressioni casuali.
+#
+# Uso: python3 tests/run_tests.py [nome ...]
+# Variabili d'ambiente: CC (default gcc), CFLAGS (default -O2)
+
+import glob
+import os
+import shlex
+import shutil
+import subprocess
+import sys
+import tempfile
+
+import fuzz_expressions
+
+TESTS_DIR = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(TESTS_DIR)
+SOURCES = os.path.join(ROOT, "2.2")
+FUZZ_COUNT = 300
+EMIT_FUZZ_COUNT = 40 # ogni script va compilato con il compilatore C
+
+# (nome, opzioni, ambiente): "cache" scrive il .nobc e "nobc" lo rilegge; i kernel degli array
+# scalari e SSE2 vanno confrontati con quelli scelti per la CPU (AVX2 se disponibile)
+MODES = [
+    ("no-cache", ("--no-cache",), {}),
+    ("simd-scalar", ("--no-cache",), {"NOOBIE_SIMD": "scalar"}),
+    ("simd-sse2", ("--no-cache",), {"NOOBIE_SIMD": "sse2"}),
+    ("cache", (), {}),
+    ("nobc", (), {}),
+    ("jit", ("--no-cache", "--jit"), {"NOOBIE_JIT_THRESHOLD": "0"}),
+    ("emit-c", None, {}),
+]
+
+
+def build(directory):
+    cc = os.environ.get("CC", "gcc")
+    cflags = shlex.split(os.environ.get("CFLAGS", "-O2"))
+    sources = sorted(glob.glob(os.path.join(SOURCES, "*.c"))) + [os.path.join(ROOT, "calc_parser.c")]
+    interpreter = os.path.join(directory, "noobie")
+    subprocess.run([cc, *cflags, "-I" + SOURCES, "-I" + ROOT, *sources, "-lm", "-pthread", "-o", interpreter],
+                   check=True)
+    return interpreter
+
+
+def build_library(directory):
+    subprocess.run(["sh", "build_libnoobie.sh", directory], cwd=SOURCES, check=True, stdout=subprocess.DEVNULL)
+    return os.path.join(directory, "libnoobie.a")
+
+
+# --emit-c: traduce lo script in C, lo compila con libnoobie.a ed esegue il programma ottenuto
+def run_emitted(interpreter, library, script):
+    base = os.path.splitext(script)[0]
+    emitted = subprocess.run([interpreter, "--emit-c", base + ".c", script], stdin=subprocess.DEVNULL,
+                             stdout=subprocess.PIPE, stderr=subprocess.PIPE, timeout=30)
+    if emitted.returncode != 0:
+        return "", "--emit-c: " + emitted.stderr.decode("utf-8", "replace"), emitted.returncode
+    cc = os.environ.get("CC", "gcc")
+    cflags = shlex.split(os.environ.get("CFLAGS", "-O2"))
+    compiled = subprocess.run([cc, *cflags, "-I" + SOURCES, "-I" + ROOT, base + ".c", library, "-lm", "-pthread",
+                               "-o", base + ".bin"], stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    if compiled.returncode != 0:
+        return "", "cc: " + compiled.stderr.decode("utf-8", "replace"), compiled.returncode
+    result = subprocess.run([base + ".bin"], stdin=subprocess.DEVNULL, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                            timeout=30)
+    return result.stdout.decode("utf-8", "replace"), result.stderr.decode("utf-8", "replace"), result.returncode
+
+
+def run(interpreter, script, options, env):
+    result = subprocess.run([interpreter, *options, script], stdin=subprocess.DEVNULL, env=dict(os.environ, **env),
+                            stdout=subprocess.PIPE, stderr=subprocess.PIPE, timeout=30)
+    return result.stdout.decode("utf-8", "replace"), result.stderr.decode("utf-8", "replace"), result.returncode
+
+
+# Risultato atteso: (stdout, stderr, codice d'uscita) dai file .out ed .err
+def expected_result(source):
+    base = os.path.splitext(source)[0]
+    with open(base + ".out", encoding="utf-8") as f:
+        stdout = f.read()
+    stderr, status = "", 0
+    if os.path.exists(base + ".err"):
+        with open(base + ".err", encoding="utf-8") as f:
+            stderr, _, last = f.read().rstrip("\n").rpartition("\n")
+        stderr = stderr + "\n" if stderr else ""
+        status = int(last.strip("[]").split()[1])
+    return stdout, stderr, status
+
+
+def describe(result):
+    stdout, stderr, status = result
+    return "%s--- stderr\n%s--- exit %d\n" % (stdout, stderr, status)
+
+
+def main():
+    names = sys.argv[1:]
+    scripts = sorted(glob.glob(os.path.join(TESTS_DIR, "*.nob")))
+    if names:
+        scripts = [s for s in scripts if os.path.splitext(os.path.basename(s))[0] in names]
+
+    failures = 0
+    with tempfile.TemporaryDirectory() as directory:
+        interpreter = build(directory)
+        library = build_library(directory)
+        for source in scripts:
+            name = os.path.basename(source)
+            script = os.path.join(directory, name)
+            shutil.copy(source, script) # il .nobc viene scritto accanto allo script
+            expected = expected_result(source)
+
+            for label, options, env in MODES:
+                if options is None:
+                    result = run_emitted(interpreter, library, script)
+                else:
+                    result = run(interpreter, script, options, env)
+                if result != expected:
+                    failures += 1
+                    print("FAIL %s (%s)\n--- atteso\n%s--- ottenuto\n%s" % (name, label, describe(expected), describe(result)))
+                    break
+            else:
+                print("ok   %s" % name)
+
+        if not names:
+            emit_c = lambda interpreter, script: run_emitted(interpreter, library, script)
+            for label, run_mode, count in (("--jit", fuzz_expressions.run_jit, FUZZ_COUNT),
+                                           ("--emit-c", emit_c, EMIT_FUZZ_COUNT)):
+                mismatches = fuzz_expressions.compare(interpreter, directory, 1, count, run_mode, label)
+                print("%s fuzz_expressions %s (%d script, %d diversi)" % ("FAIL" if mismatches else "ok  ", label,
+                                                                           count, mismatches))
+                failures += mismatches != 0
+                scripts.append("fuzz_expressions " + label)
+
+    print("%d test, %d falliti" % (len(scripts), failures))
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())